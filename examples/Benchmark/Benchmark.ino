@@ -0,0 +1,323 @@
+/*
+ * Measures time (and bus traffic if CAP1188_ENABLE_STATS build flag is set) of driver operations
+ * at several bus clocks, then prints a comparison table over Serial. Results of different library
+ * versions can be diffed to catch performance regressions.
+ *
+ * NOTE: CAP1188_ENABLE_STATS has to be passed as a build flag (i.e. build_flags = -DCAP1188_ENABLE_STATS
+ * in platformio.ini), defining it within the sketch does not affect the library. Asynchronous operations are only
+ * measured on ESP32. Thresholds and counts have to be compiled in (see CAP1188_FEATURES)
+ */
+#include <Wire.h>
+#include <SPI.h>
+#include "CAP1188.h"
+
+// Select interface CAP1188 is connected to (comment out the other one) and adjust wiring
+#define BENCHMARK_I2C
+// #define BENCHMARK_SPI
+
+#define BENCHMARK_I2C_ADDRESS                            CAP1188_I2C_DEFAULT_ADDRESS
+#define BENCHMARK_CS_PIN                                 5
+#define BENCHMARK_RESET_PIN                              4
+
+// Clocks to compare
+#if defined(BENCHMARK_SPI)
+static const uint32_t clocks[] = {500000, 1000000, 2000000};
+#else
+static const uint32_t clocks[] = {100000, 400000, 1000000};
+#endif
+
+// Amount of repetitions of every operation (init is repeated less, as cold init includes reset pulse)
+#define BENCHMARK_ITERATIONS                             200
+#define BENCHMARK_INIT_ITERATIONS                        10
+
+// Operations measured
+#define BENCHMARK_INIT_COLD                              0
+#define BENCHMARK_INIT_WARM                              1
+#define BENCHMARK_SENSOR_INPUTS                          2
+#define BENCHMARK_THRESHOLD_SET                          3
+#define BENCHMARK_THRESHOLD_GET                          4
+#define BENCHMARK_THRESHOLDS_SET                         5
+#define BENCHMARK_DELTA_COUNTS                           6
+#define BENCHMARK_CALIBRATIONS                           7
+#define BENCHMARK_BURST_READ                             8
+#define BENCHMARK_ASYNC_SUBMIT                           9
+#define BENCHMARK_ASYNC_COMPLETE                         10
+#define BENCHMARK_OPERATIONS                             11
+
+static const char *operationNames[BENCHMARK_OPERATIONS] = {
+    "init (cold)",
+    "init (warm)",
+    "getSensorInputs()",
+    "setSensorInputThreshold()",
+    "getSensorInputThreshold()",
+    "setSensorInputThresholds()",
+    "getDeltaCounts()",
+    "getCalibrations()",
+    "readRegisters(32)",
+    "getSensorInputsAsync() submit",
+    "getSensorInputsAsync() done",
+};
+
+struct BenchmarkResult
+{
+    uint32_t usPerOperation;
+    uint32_t transactions; // Per 100 operations, so averages below 1 are visible
+    uint32_t bytes;        // Per 100 operations
+    bool done;
+};
+
+static BenchmarkResult results[BENCHMARK_OPERATIONS][sizeof(clocks) / sizeof(clocks[0])];
+
+CAP1188 cap1188;
+
+#if defined(ESP32)
+static volatile bool asyncDone;
+
+static void asyncCallback(void *arg, bool success, const uint8_t *data, uint8_t len)
+{
+    asyncDone = true;
+}
+#endif
+
+/**
+ * @brief Initialises CAP1188 using selected interface
+ * @param initMode CAP1188_INIT_...
+ * @return void
+ */
+static void initDevice(uint8_t initMode)
+{
+#if defined(BENCHMARK_SPI)
+    cap1188.initSPI(BENCHMARK_CS_PIN, BENCHMARK_RESET_PIN, initMode);
+#else
+    cap1188.initI2C(BENCHMARK_I2C_ADDRESS, BENCHMARK_RESET_PIN, initMode);
+#endif
+}
+
+/**
+ * @brief Sets clock of selected interface
+ * @param clock clock frequency in Hz
+ * @return void
+ */
+static void setClock(uint32_t clock)
+{
+#if defined(BENCHMARK_SPI)
+    cap1188.setSPIClock(clock);
+#else
+    cap1188.setI2CClock(clock);
+#endif
+}
+
+/**
+ * @brief Runs a single operation once
+ * @param operation BENCHMARK_...
+ * @return void
+ */
+static void runOperation(uint8_t operation)
+{
+    static uint8_t thresholds[8] = {0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40};
+    static int8_t deltaCounts[8];
+    static uint16_t calibrations[8];
+    static uint8_t buff[32];
+
+    switch (operation)
+    {
+    case BENCHMARK_INIT_COLD:
+        initDevice(CAP1188_INIT_COLD);
+        break;
+
+    case BENCHMARK_INIT_WARM:
+        initDevice(CAP1188_INIT_WARM);
+        break;
+
+    case BENCHMARK_SENSOR_INPUTS:
+        cap1188.getSensorInputs();
+        break;
+
+    case BENCHMARK_THRESHOLD_SET:
+        cap1188.setSensorInputThreshold(2, 0x40);
+        break;
+
+    case BENCHMARK_THRESHOLD_GET:
+        cap1188.getSensorInputThreshold(2);
+        break;
+
+    case BENCHMARK_THRESHOLDS_SET:
+        cap1188.setSensorInputThresholds(thresholds);
+        break;
+
+    case BENCHMARK_DELTA_COUNTS:
+        cap1188.getDeltaCounts(deltaCounts);
+        break;
+
+    case BENCHMARK_CALIBRATIONS:
+        cap1188.getCalibrations(calibrations);
+        break;
+
+    case BENCHMARK_BURST_READ:
+        cap1188.readRegisters(0x00, buff, sizeof(buff));
+        break;
+
+#if defined(ESP32)
+    case BENCHMARK_ASYNC_SUBMIT:
+        // Only time caller is blocked for is measured, completion is awaited outside of measurement
+        asyncDone = false;
+        if (!cap1188.getSensorInputsAsync(asyncCallback))
+        {
+            // Nothing to wait for, as callback is not called for a request that was not queued
+            asyncDone = true;
+        }
+        break;
+
+    case BENCHMARK_ASYNC_COMPLETE:
+        asyncDone = false;
+        if (cap1188.getSensorInputsAsync(asyncCallback))
+        {
+            while (!asyncDone)
+            {
+                yield();
+            }
+        }
+        break;
+#endif
+    }
+}
+
+/**
+ * @brief Measures an operation and stores its result
+ * @param operation BENCHMARK_...
+ * @param clockIndex index of a clock in clocks[]
+ * @return void
+ */
+static void measure(uint8_t operation, uint8_t clockIndex)
+{
+    uint16_t iterations = operation <= BENCHMARK_INIT_WARM ? BENCHMARK_INIT_ITERATIONS : BENCHMARK_ITERATIONS;
+    uint32_t totalUs = 0;
+#if defined(CAP1188_ENABLE_STATS)
+    cap1188.resetStats();
+#endif
+    for (uint16_t i = 0; i < iterations; i++)
+    {
+        uint32_t startTime = micros();
+        runOperation(operation);
+        totalUs += micros() - startTime;
+#if defined(ESP32)
+        // Asynchronous request is finished outside of measurement, so the next one does not wait for a full queue
+        while (operation == BENCHMARK_ASYNC_SUBMIT && !asyncDone)
+        {
+            yield();
+        }
+#endif
+    }
+
+    BenchmarkResult &result = results[operation][clockIndex];
+    result.usPerOperation = totalUs / iterations;
+#if defined(CAP1188_ENABLE_STATS)
+    const CAP1188Stats &stats = cap1188.getStats();
+    result.transactions = stats.transactions * 100 / iterations;
+    result.bytes = stats.bytes * 100 / iterations;
+#endif
+    result.done = true;
+}
+
+#if defined(CAP1188_ENABLE_STATS)
+/**
+ * @brief Prints a value with 2 decimals, which was multiplied by 100
+ * @param value value multiplied by 100
+ * @return void
+ */
+static void printHundredths(uint32_t value)
+{
+    Serial.print(value / 100);
+    Serial.print('.');
+    if (value % 100 < 10)
+    {
+        Serial.print('0');
+    }
+    Serial.print(value % 100);
+}
+#endif
+
+/**
+ * @brief Prints comparison table: a row per operation, us/op (and transactions/op, bytes/op) per clock
+ * @return void
+ */
+static void printResults()
+{
+    Serial.print("operation");
+    for (uint8_t c = 0; c < sizeof(clocks) / sizeof(clocks[0]); c++)
+    {
+        Serial.print(" | ");
+        Serial.print(clocks[c] / 1000);
+        Serial.print("kHz us/op");
+#if defined(CAP1188_ENABLE_STATS)
+        Serial.print(", tx/op, bytes/op");
+#endif
+    }
+    Serial.println();
+
+    for (uint8_t operation = 0; operation < BENCHMARK_OPERATIONS; operation++)
+    {
+        if (!results[operation][0].done)
+        {
+            continue;
+        }
+        Serial.print(operationNames[operation]);
+        for (uint8_t c = 0; c < sizeof(clocks) / sizeof(clocks[0]); c++)
+        {
+            const BenchmarkResult &result = results[operation][c];
+            Serial.print(" | ");
+            Serial.print(result.usPerOperation);
+#if defined(CAP1188_ENABLE_STATS)
+            Serial.print(", ");
+            printHundredths(result.transactions);
+            Serial.print(", ");
+            printHundredths(result.bytes);
+#endif
+        }
+        Serial.println();
+    }
+}
+
+void setup()
+{
+    Serial.begin(115200);
+#if defined(BENCHMARK_SPI)
+    SPI.begin();
+#else
+    Wire.begin();
+#endif
+
+    initDevice(CAP1188_INIT_COLD);
+    if (cap1188.getProductId() != CAP1188_PRODUCT_ID)
+    {
+        Serial.println("CAP1188 not found, check wiring and BENCHMARK_... settings");
+        return;
+    }
+#if defined(ESP32)
+    bool asyncAvailable = cap1188.startTask();
+    if (!asyncAvailable)
+    {
+        Serial.println("Failed to start CAP1188 task, asynchronous operations are skipped");
+    }
+#else
+    bool asyncAvailable = false;
+#endif
+
+    for (uint8_t c = 0; c < sizeof(clocks) / sizeof(clocks[0]); c++)
+    {
+        setClock(clocks[c]);
+        for (uint8_t operation = 0; operation < BENCHMARK_OPERATIONS; operation++)
+        {
+            if (operation >= BENCHMARK_ASYNC_SUBMIT && !asyncAvailable)
+            {
+                continue;
+            }
+            measure(operation, c);
+        }
+    }
+    printResults();
+}
+
+void loop()
+{
+}
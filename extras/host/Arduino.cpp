@@ -0,0 +1,234 @@
+#include <Arduino.h>
+#include <Wire.h>
+#include <SPI.h>
+#include <chrono>
+#include <thread>
+
+TwoWire Wire;
+SPIClass SPI;
+
+static const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+static bool pinLow[HOST_PINS];
+static uint8_t pinLevels[HOST_PINS];
+static uint8_t pinModes[HOST_PINS];
+static void (*interruptHandlers[HOST_PINS])();
+static HostPinDevice *pinDevice = NULL;
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    if (pin < HOST_PINS)
+    {
+        pinModes[pin] = mode;
+        if (pinDevice)
+        {
+            pinDevice->pinChanged(pin);
+        }
+    }
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+    if (pin < HOST_PINS)
+    {
+        pinLevels[pin] = value ? HIGH : LOW;
+        if (pinDevice)
+        {
+            pinDevice->pinChanged(pin);
+        }
+    }
+}
+
+int digitalRead(uint8_t pin)
+{
+    if (pin >= HOST_PINS)
+    {
+        return HIGH;
+    }
+    int level = pinDevice ? pinDevice->pinLevel(pin) : -1;
+    if (level >= 0)
+    {
+        return level;
+    }
+    // Nothing pulls GPIOs down unless a test does (i.e. ALERT is not asserted)
+    return pinLow[pin] ? LOW : HIGH;
+}
+
+uint8_t hostGetPin(uint8_t pin)
+{
+    return pin < HOST_PINS ? pinLevels[pin] : LOW;
+}
+
+uint8_t hostGetPinMode(uint8_t pin)
+{
+    return pin < HOST_PINS ? pinModes[pin] : INPUT;
+}
+
+void hostSetPinDevice(HostPinDevice *device)
+{
+    pinDevice = device;
+}
+
+void hostSetPin(uint8_t pin, uint8_t value)
+{
+    if (pin < HOST_PINS)
+    {
+        pinLow[pin] = value == LOW;
+    }
+}
+
+void hostRaiseInterrupt(uint8_t interrupt)
+{
+    if (interrupt < HOST_PINS && interruptHandlers[interrupt])
+    {
+        interruptHandlers[interrupt]();
+    }
+}
+
+int digitalPinToInterrupt(uint8_t pin)
+{
+    return pin;
+}
+
+void attachInterrupt(uint8_t interrupt, void (*isr)(), int mode)
+{
+    if (interrupt < HOST_PINS)
+    {
+        interruptHandlers[interrupt] = isr;
+    }
+}
+
+void detachInterrupt(uint8_t interrupt)
+{
+    if (interrupt < HOST_PINS)
+    {
+        interruptHandlers[interrupt] = NULL;
+    }
+}
+void noInterrupts() {}
+void interrupts() {}
+
+unsigned long millis()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+unsigned long micros()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+void delay(unsigned long ms)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(unsigned int us)
+{
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+void yield()
+{
+    std::this_thread::yield();
+}
+
+size_t Print::write(const uint8_t *buff, size_t len)
+{
+    size_t written = 0;
+    while (written < len && write(buff[written]))
+    {
+        written++;
+    }
+    return written;
+}
+
+static HostI2CDevice *i2cDevice = NULL;
+
+void hostSetI2CDevice(HostI2CDevice *device)
+{
+    i2cDevice = device;
+}
+
+TwoWire::TwoWire() : _address(0), _txLen(0), _rxLen(0), _rxIndex(0) {}
+void TwoWire::begin() {}
+void TwoWire::setClock(uint32_t clock) {}
+
+void TwoWire::beginTransmission(uint8_t address)
+{
+    _address = address;
+    _txLen = 0;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop)
+{
+    if (!i2cDevice)
+    {
+        return 2; // Address NACK
+    }
+    return i2cDevice->write(_address, _txBuffer, _txLen, sendStop);
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t len, uint8_t sendStop)
+{
+    if (len > HOST_WIRE_BUFFER_LENGTH)
+    {
+        len = HOST_WIRE_BUFFER_LENGTH;
+    }
+    _rxIndex = 0;
+    _rxLen = i2cDevice ? i2cDevice->read(address, _rxBuffer, len, sendStop) : 0;
+    return _rxLen;
+}
+
+size_t TwoWire::write(uint8_t data)
+{
+    if (_txLen >= HOST_WIRE_BUFFER_LENGTH)
+    {
+        return 0;
+    }
+    _txBuffer[_txLen++] = data;
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t *buff, size_t len)
+{
+    size_t written = 0;
+    while (written < len && write(buff[written]))
+    {
+        written++;
+    }
+    return written;
+}
+
+int TwoWire::available()
+{
+    return _rxLen - _rxIndex;
+}
+
+int TwoWire::read()
+{
+    return _rxIndex < _rxLen ? _rxBuffer[_rxIndex++] : -1;
+}
+
+static HostSPIDevice *spiDevice = NULL;
+
+void hostSetSPIDevice(HostSPIDevice *device)
+{
+    spiDevice = device;
+}
+
+void SPIClass::begin() {}
+void SPIClass::beginTransaction(SPISettings settings) {}
+void SPIClass::endTransaction() {}
+
+void SPIClass::transferBytes(const uint8_t *data, uint8_t *out, uint32_t len)
+{
+    if (spiDevice)
+    {
+        spiDevice->transfer(data, out, len);
+    }
+    else if (out)
+    {
+        memset(out, 0xFF, len);
+    }
+}
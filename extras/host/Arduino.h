@@ -0,0 +1,59 @@
+#ifndef _CAP1188_HOST_ARDUINO_H_
+#define _CAP1188_HOST_ARDUINO_H_
+
+// Minimal subset of Arduino API used by the driver, so it can be built and run on a host (see Makefile).
+// GPIOs read HIGH unless set by hostSetPin(...) or driven by a HostPinDevice, interrupts are only raised by hostRaiseInterrupt(...),
+// time is taken from the host clock
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define HIGH                                             0x01
+#define LOW                                              0x00
+
+#define INPUT                                            0x00
+#define OUTPUT                                           0x01
+#define INPUT_PULLUP                                     0x02
+
+#define FALLING                                          0x02
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+int digitalPinToInterrupt(uint8_t pin);
+void attachInterrupt(uint8_t interrupt, void (*isr)(), int mode);
+void detachInterrupt(uint8_t interrupt);
+void noInterrupts();
+void interrupts();
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+// Host only: drive level of a GPIO read by digitalRead(...), call handler attached to an interrupt,
+// get level last written by digitalWrite(...) and mode last set by pinMode(...)
+#define HOST_PINS                                        64
+void hostSetPin(uint8_t pin, uint8_t value);
+void hostRaiseInterrupt(uint8_t interrupt);
+uint8_t hostGetPin(uint8_t pin);
+uint8_t hostGetPinMode(uint8_t pin);
+
+// Host only: model of a device connected to GPIOs (i.e. bit-banged bus), sees every pin change and drives pins it outputs
+class HostPinDevice{
+    public:
+        virtual ~HostPinDevice() {}
+        virtual void pinChanged(uint8_t pin) = 0;     // Called after pinMode(...) or digitalWrite(...) of a pin
+        virtual int pinLevel(uint8_t pin) = 0;        // Level driven by a device, -1 if it does not drive a pin
+};
+void hostSetPinDevice(HostPinDevice *device);      // NULL to disconnect
+
+class Print{
+    public:
+        virtual size_t write(uint8_t data) = 0;
+        virtual size_t write(const uint8_t *buff, size_t len);
+};
+
+#endif
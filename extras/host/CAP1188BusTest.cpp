@@ -0,0 +1,288 @@
+/*
+ * Host tests of bus framing of the driver: I2C transactions and status codes, SPI 4-wire frames and register pointer cache,
+ * SPI 3-wire bit-banging. The driver talks to bus level models of CAP1188 (see HostDevices.h)
+ */
+#include "HostTest.h"
+#include "HostDevices.h"
+#include "CAP1188.h"
+#include "CAP1188_reg.h"
+
+#if !defined(CAP1188_DISABLE_I2C)
+/**
+ * @brief Checks I2C framing: initialisation, register pointer write followed by a read, bursts split by Wire buffer length
+ * @return void
+ */
+static void testI2CFraming()
+{
+    CAP1188Sim sim;
+    SimI2CDevice device(sim, 0x29);
+    hostSetI2CDevice(&device);
+    CAP1188 cap1188;
+    cap1188.initI2C(Wire, 0x29, CAP1188_NO_RESET_PIN);
+    CHECK(cap1188.isReady());
+    CHECK(sim.peekRegister(CAP1188_MULTIPLE_TOUCH_CONFIGURATION_REG) == CAP1188_INIT_MULTIPLE_TOUCH_CONFIG);
+    CHECK(sim.peekRegister(CAP1188_SENSOR_INPUT_LED_LINKING_REG) == CAP1188_INIT_LED_LINKING);
+
+    uint8_t ids[3];
+    device.transmissions = 0;
+    CHECK(cap1188.readRegisters(CAP1188_PRODUCT_ID_REG, ids, sizeof(ids)));
+    CHECK(ids[0] == CAP1188_PRODUCT_ID && ids[1] == CAP1188_MANUFACTURER_ID && ids[2] == 0x83);
+    CHECK(device.transmissions == 2);
+
+    // Burst longer than Wire buffer takes two transactions (register address write and read each)
+    uint8_t regs[CAP1188_I2C_BUFFER_LENGTH + 8];
+    for (uint8_t i = 0; i < sizeof(regs); i++)
+    {
+        sim.pokeRegister(0x80 + i, i);
+    }
+    device.transmissions = 0;
+    CHECK(cap1188.readRegisters(0x80, regs, sizeof(regs)));
+    CHECK(device.transmissions == 4);
+    bool match = true;
+    for (uint8_t i = 0; i < sizeof(regs); i++)
+    {
+        match = match && regs[i] == i;
+    }
+    CHECK(match);
+
+    // Write burst is a single transaction
+    const uint8_t thresholds[8] = {0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17};
+    device.transmissions = 0;
+    CHECK(cap1188.writeRegisters(CAP1188_SENSOR_INPUT_1_THRESHOLD_REG, thresholds, sizeof(thresholds)));
+    CHECK(device.transmissions == 1);
+    CHECK(sim.peekRegister(CAP1188_SENSOR_INPUT_1_THRESHOLD_REG) == 0x10 && sim.peekRegister(CAP1188_SENSOR_INPUT_8_THRESHOLD_REG) == 0x17);
+
+    hostSetI2CDevice(NULL);
+}
+
+/**
+ * @brief Checks status codes of failed I2C accesses and retries of setRetryPolicy(...)
+ * @return void
+ */
+static void testI2CStatus()
+{
+    CAP1188 uninitialised;
+    CHECK(uninitialised.getProductId() == 0);
+    CHECK(uninitialised.getLastStatus() == CAP1188_STATUS_NOT_INITIALISED);
+
+    CAP1188Sim sim;
+    SimI2CDevice device(sim, 0x29);
+    hostSetI2CDevice(&device);
+    CAP1188 cap1188;
+    cap1188.initI2C(Wire, 0x29, CAP1188_NO_RESET_PIN);
+    cap1188.setRetryPolicy(0, 0);
+
+    device.failingTransmissions = 1;
+    device.failResult = 2;
+    CHECK(cap1188.getProductId() == 0);
+    CHECK(cap1188.getLastStatus() == CAP1188_STATUS_NACK);
+    device.failingTransmissions = 1;
+    device.failResult = 3;
+    const uint8_t threshold = 0x20;
+    CHECK(!cap1188.writeRegisters(CAP1188_SENSOR_INPUT_1_THRESHOLD_REG, &threshold, 1));
+    CHECK(cap1188.getLastStatus() == CAP1188_STATUS_NACK);
+    device.failingTransmissions = 1;
+    device.failResult = 4;
+    CHECK(cap1188.getProductId() == 0);
+    CHECK(cap1188.getLastStatus() == CAP1188_STATUS_BUS_ERROR);
+
+    uint8_t ids[3];
+    device.shortReads = 1;
+    CHECK(!cap1188.readRegisters(CAP1188_PRODUCT_ID_REG, ids, sizeof(ids)));
+    CHECK(cap1188.getLastStatus() == CAP1188_STATUS_SHORT_READ);
+    // Bytes of the short read are not taken by the next access
+    CHECK(cap1188.getManufacturerId() == CAP1188_MANUFACTURER_ID);
+    CHECK(cap1188.getLastStatus() == CAP1188_STATUS_OK);
+
+    // 2 retries recover from 2 failed attempts, but not from 3
+    cap1188.setRetryPolicy(2, 0);
+#if defined(CAP1188_ENABLE_STATS)
+    cap1188.resetStats();
+#endif
+    device.failingTransmissions = 2;
+    device.failResult = 2;
+    device.transmissions = 0;
+    CHECK(cap1188.getProductId() == CAP1188_PRODUCT_ID);
+    CHECK(cap1188.getLastStatus() == CAP1188_STATUS_OK);
+    CHECK(device.transmissions == 4);
+    device.failingTransmissions = 3;
+    CHECK(cap1188.getProductId() == 0);
+    CHECK(cap1188.getLastStatus() == CAP1188_STATUS_NACK);
+#if defined(CAP1188_ENABLE_STATS)
+    CHECK(cap1188.getStats().retries == 4);
+#endif
+
+    // Nothing responds at another address
+    CAP1188 absent;
+    absent.setRetryPolicy(0, 0);
+    absent.initI2C(Wire, 0x28, CAP1188_NO_RESET_PIN);
+    CHECK(absent.getProductId() == 0);
+    CHECK(absent.getLastStatus() == CAP1188_STATUS_NACK);
+
+    hostSetI2CDevice(NULL);
+}
+#endif
+
+#if !defined(CAP1188_DISABLE_SPI)
+/**
+ * @brief Compares the last SPI frame with expected bytes
+ * @param device SPI model
+ * @param expected expected bytes sent by the driver
+ * @param len amount of expected bytes
+ * @return true if frame matches
+ */
+static bool lastFrameIs(const SimSPIDevice &device, const uint8_t *expected, uint8_t len)
+{
+    return device.lastFrame.size() == len && memcmp(device.lastFrame.data(), expected, len) == 0;
+}
+
+/**
+ * @brief Checks SPI 4-wire framing: commands of every access, register pointer reuse by sequential accesses (also across
+ * split bursts), pointer invalidation beyond the last register and read followed by write within a single frame
+ * @return void
+ */
+static void testSPIFraming()
+{
+    CAP1188Sim sim;
+    SimSPIDevice device(sim, 5);
+    hostSetSPIDevice(&device);
+    CAP1188 cap1188;
+    cap1188.initSPI(SPI, 5, CAP1188_NO_RESET_PIN);
+    CHECK(cap1188.isReady());
+    CHECK(device.interfaceResets > 0);
+    CHECK(sim.peekRegister(CAP1188_SENSOR_INPUT_LED_LINKING_REG) == CAP1188_INIT_LED_LINKING);
+
+    CHECK(cap1188.getProductId() == CAP1188_PRODUCT_ID);
+    const uint8_t readProductId[] = {0x7D, CAP1188_PRODUCT_ID_REG, 0x7F, 0xFF};
+    CHECK(lastFrameIs(device, readProductId, sizeof(readProductId)));
+    // Next registers are read without setting register pointer
+    const uint8_t readNext[] = {0x7F, 0xFF};
+    CHECK(cap1188.getManufacturerId() == CAP1188_MANUFACTURER_ID);
+    CHECK(lastFrameIs(device, readNext, sizeof(readNext)));
+    CHECK(cap1188.getRevision() == 0x83);
+    CHECK(lastFrameIs(device, readNext, sizeof(readNext)));
+    // Register pointer is not known beyond the last register
+    const uint8_t readRevision[] = {0x7D, CAP1188_REVISION_REG, 0x7F, 0xFF};
+    CHECK(cap1188.getRevision() == 0x83);
+    CHECK(lastFrameIs(device, readRevision, sizeof(readRevision)));
+
+    // Writes of consecutive registers continue where the previous one ended
+    const uint8_t low[4] = {0x21, 0x22, 0x23, 0x24}, high[4] = {0x25, 0x26, 0x27, 0x28};
+    CHECK(cap1188.writeRegisters(CAP1188_SENSOR_INPUT_1_THRESHOLD_REG, low, 4));
+    CHECK(device.lastFrame.size() == 10 && device.lastFrame[0] == 0x7D && device.lastFrame[2] == 0x7E);
+    CHECK(cap1188.writeRegisters(CAP1188_SENSOR_INPUT_5_THRESHOLD_REG, high, 4));
+    const uint8_t writeHigh[] = {0x7E, 0x25, 0x7E, 0x26, 0x7E, 0x27, 0x7E, 0x28};
+    CHECK(lastFrameIs(device, writeHigh, sizeof(writeHigh)));
+    uint8_t thresholds[8];
+    CHECK(cap1188.readRegisters(CAP1188_SENSOR_INPUT_1_THRESHOLD_REG, thresholds, sizeof(thresholds)));
+    CHECK(thresholds[0] == 0x21 && thresholds[7] == 0x28);
+
+    // Burst longer than CAP1188_MAX_BURST_LENGTH is split, the second frame reuses register pointer
+    uint8_t regs[CAP1188_MAX_BURST_LENGTH + 8];
+    for (uint8_t i = 0; i < sizeof(regs); i++)
+    {
+        sim.pokeRegister(0x80 + i, 0x40 + i);
+    }
+    uint32_t frames = device.frames;
+    CHECK(cap1188.readRegisters(0x80, regs, sizeof(regs)));
+    CHECK(device.frames - frames == 2);
+    CHECK(device.lastFrame.size() == 9 && device.lastFrame[0] == 0x7F);
+    CHECK(regs[0] == 0x40 && regs[CAP1188_MAX_BURST_LENGTH] == 0x40 + CAP1188_MAX_BURST_LENGTH && regs[sizeof(regs) - 1] == 0x40 + sizeof(regs) - 1);
+
+    // Polling does not benefit from the cache: status read and INT clear both set register pointer
+    sim.setTouches(0x01);
+    CHECK(cap1188.getSensorInputs() == 0x01);
+    sim.setTouches(0x00);
+    sim.setTouches(0x01);
+    uint32_t setPointerCommands = device.setPointerCommands;
+    CHECK(cap1188.getSensorInputs() == 0x01);
+    CHECK(device.setPointerCommands - setPointerCommands == 2);
+    CHECK(!(sim.peekRegister(CAP1188_MAIN_CONTROL_REG) & CAP1188_MAIN_CONTROL_INT_BIT));
+
+#if CAP1188_HAS_FEATURE(CAP1188_FEATURE_LED)
+    // Status read and LED write share a single frame, data of the read is clocked out by the write commands
+    sim.setTouches(0x00);
+    CHECK(cap1188.getSensorInputs() == 0x01);
+    cap1188.setLeds(0x05);
+    frames = device.frames;
+    CHECK(cap1188.getSensorInputsAndFlushLeds() == 0x00);
+    CHECK(device.frames - frames == 1);
+    const uint8_t exchange[] = {0x7D, CAP1188_SENSOR_INPUT_STATUS_REG, 0x7F, 0x7D, CAP1188_LED_OUTPUT_CONTROL_REG, 0x7E, 0x05};
+    CHECK(lastFrameIs(device, exchange, sizeof(exchange)));
+    CHECK(sim.peekRegister(CAP1188_LED_OUTPUT_CONTROL_REG) == 0x05);
+#endif
+
+    // Interface reset leaves register pointer unknown, even if it was cached at the register warm initialisation reads first
+    uint8_t reg;
+    CHECK(cap1188.readRegisters(CAP1188_PRODUCT_ID_REG - 1, &reg, 1));
+    uint32_t resets = device.interfaceResets;
+    cap1188.initSPI(SPI, 5, CAP1188_NO_RESET_PIN, CAP1188_INIT_WARM);
+    CHECK(device.interfaceResets > resets);
+    CHECK(cap1188.isReady());
+
+    CHECK(device.unknownPointerAccesses == 0);
+    CHECK(device.unselectedFrames == 0);
+    hostSetSPIDevice(NULL);
+}
+
+/**
+ * @brief Checks SPI 3-wire bit-banging: data read back, SDIO is never driven by both sides, direction is only switched
+ * around data read and SDIO is released after every frame
+ * @return void
+ */
+static void testSPI3Wire()
+{
+    CAP1188Sim sim;
+    Sim3WireDevice device(sim, 6, 7, 8);
+    hostSetPinDevice(&device);
+    CAP1188 cap1188;
+    cap1188.setSPIClock(1000000);
+    cap1188.initSPI3Wire(6, 7, 8, CAP1188_NO_RESET_PIN);
+    CHECK(cap1188.isReady());
+    CHECK(device.interfaceResets > 0);
+    CHECK(sim.peekRegister(CAP1188_SENSOR_INPUT_LED_LINKING_REG) == CAP1188_INIT_LED_LINKING);
+
+    uint8_t ids[3];
+    device.directionSwitches = 0;
+    CHECK(cap1188.readRegisters(CAP1188_PRODUCT_ID_REG, ids, sizeof(ids)));
+    CHECK(ids[0] == CAP1188_PRODUCT_ID && ids[1] == CAP1188_MANUFACTURER_ID && ids[2] == 0x83);
+    // Data line turns into an input for every register read and back into an output for the next command
+    CHECK(device.directionSwitches == 2 * sizeof(ids));
+    CHECK(hostGetPinMode(8) == INPUT);
+
+    const uint8_t thresholds[8] = {0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37};
+    device.directionSwitches = 0;
+    CHECK(cap1188.writeRegisters(CAP1188_SENSOR_INPUT_1_THRESHOLD_REG, thresholds, sizeof(thresholds)));
+    // Write frame only takes data line once and releases it at the end
+    CHECK(device.directionSwitches == 2);
+    CHECK(hostGetPinMode(8) == INPUT);
+    uint8_t readBack[8];
+    CHECK(cap1188.readRegisters(CAP1188_SENSOR_INPUT_1_THRESHOLD_REG, readBack, sizeof(readBack)));
+    CHECK(memcmp(readBack, thresholds, sizeof(thresholds)) == 0);
+
+    sim.setTouches(0x80);
+    CHECK(cap1188.getSensorInputs() == 0x80);
+    CHECK(!(sim.peekRegister(CAP1188_MAIN_CONTROL_REG) & CAP1188_MAIN_CONTROL_INT_BIT));
+
+    CHECK(device.contentions == 0);
+    CHECK(device.floatingBits == 0);
+    CHECK(device.unknownPointerAccesses == 0);
+    hostSetPinDevice(NULL);
+}
+#endif
+
+/**
+ * @brief Runs tests of this file
+ * @return void
+ */
+void runBusTests()
+{
+#if !defined(CAP1188_DISABLE_I2C)
+    testI2CFraming();
+    testI2CStatus();
+#endif
+#if !defined(CAP1188_DISABLE_SPI)
+    testSPIFraming();
+    testSPI3Wire();
+#endif
+}
@@ -0,0 +1,387 @@
+/*
+ * Host tests of driver level paths running on CAP1188Sim: diffed configuration bursts, initialisation modes, retries,
+ * threshold broadcast with verification, calibration snapshot and restore
+ */
+#include "HostTest.h"
+#include "HostDevices.h"
+#include "CAP1188.h"
+#include "CAP1188_reg.h"
+
+// Model of RESET pin of CAP1188: rising edge brings registers back to their power-on defaults
+class ResetPin : public HostPinDevice{
+    public:
+        ResetPin(CAP1188Sim &sim, uint8_t pin) : resets(0), _sim(sim), _pin(pin), _level(LOW) {}
+        void pinChanged(uint8_t pin)
+        {
+            if (pin == _pin && hostGetPin(_pin) != _level)
+            {
+                _level = hostGetPin(_pin);
+                if (_level == HIGH)
+                {
+                    _sim.reset();
+                    resets++;
+                }
+            }
+        }
+        int pinLevel(uint8_t pin)
+        {
+            return -1;
+        }
+        uint32_t resets;
+
+    private:
+        CAP1188Sim &_sim;
+        uint8_t _pin;
+        uint8_t _level;
+};
+
+/**
+ * @brief Looks for a write starting at a register
+ * @param sim simulator, writes of which were recorded
+ * @param startAddress first register address of a write
+ * @param len expected amount of registers written (0 for any)
+ * @return true if such write was recorded
+ */
+static bool hasWrite(const RecordingSim &sim, uint8_t startAddress, uint8_t len = 0)
+{
+    for (size_t i = 0; i < sim.writes.size(); i++)
+    {
+        if (sim.writes[i].startAddress == startAddress && (len == 0 || sim.writes[i].len == len))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Checks that applyConfig(...) only writes changed registers or ones with unknown state, consecutive ones within a burst
+ * @return void
+ */
+static void testApplyConfig()
+{
+    RecordingSim sim;
+    CAP1188 cap1188;
+    cap1188.initTransport(sim, CAP1188_NO_RESET_PIN);
+    CHECK(cap1188.syncShadow());
+
+    CAP1188Config config;
+    config.averagingAndSampling = sim.peekRegister(CAP1188_AVERAGING_AND_SAMPLING_CONFIG_REG);
+    config.multipleTouch = sim.peekRegister(CAP1188_MULTIPLE_TOUCH_CONFIGURATION_REG);
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        config.thresholds[i] = sim.peekRegister(CAP1188_SENSOR_INPUT_1_THRESHOLD_REG + i);
+    }
+    config.standby = sim.peekRegister(CAP1188_STANDBY_CONFIGURATION_REG);
+    config.ledLinking = sim.peekRegister(CAP1188_SENSOR_INPUT_LED_LINKING_REG);
+
+    // Nothing differs from shadow register file
+    sim.writes.clear();
+    CHECK(cap1188.applyConfig(config));
+    CHECK(sim.writes.empty());
+
+    config.thresholds[3] = 0x50;
+    config.standby = 0x3A;
+    sim.writes.clear();
+    CHECK(cap1188.applyConfig(config));
+    CHECK(sim.writes.size() == 2);
+    CHECK(hasWrite(sim, CAP1188_SENSOR_INPUT_4_THRESHOLD_REG, 1));
+    CHECK(hasWrite(sim, CAP1188_STANDBY_CONFIGURATION_REG, 1));
+
+    // Write of the 1st Input threshold is broadcast by CAP1188, so all thresholds are written within the same burst
+    config.thresholds[0] = 0x20;
+    sim.writes.clear();
+    CHECK(cap1188.applyConfig(config));
+    CHECK(sim.writes.size() == 1);
+    CHECK(hasWrite(sim, CAP1188_SENSOR_INPUT_1_THRESHOLD_REG, 8));
+    CHECK(sim.peekRegister(CAP1188_SENSOR_INPUT_1_THRESHOLD_REG) == 0x20);
+    CHECK(sim.peekRegister(CAP1188_SENSOR_INPUT_4_THRESHOLD_REG) == 0x50);
+    CHECK(sim.peekRegister(CAP1188_SENSOR_INPUT_8_THRESHOLD_REG) == config.thresholds[7]);
+
+    // Registers, state of which is not known yet, are written (the ones written by initialisation are known)
+    CAP1188 other;
+    other.initTransport(sim, CAP1188_NO_RESET_PIN);
+    sim.writes.clear();
+    CHECK(other.applyConfig(config));
+    CHECK(sim.writes.size() == 3);
+    CHECK(hasWrite(sim, CAP1188_AVERAGING_AND_SAMPLING_CONFIG_REG, 1));
+    CHECK(hasWrite(sim, CAP1188_SENSOR_INPUT_1_THRESHOLD_REG, 8));
+    CHECK(hasWrite(sim, CAP1188_STANDBY_CONFIGURATION_REG, 1));
+}
+
+#if CAP1188_HAS_FEATURE(CAP1188_FEATURE_LED)
+/**
+ * @brief Checks that applyLedConfig(...) only writes changed registers, consecutive ones within a burst
+ * @return void
+ */
+static void testApplyLedConfig()
+{
+    RecordingSim sim;
+    CAP1188 cap1188;
+    cap1188.initTransport(sim, CAP1188_NO_RESET_PIN);
+    CHECK(cap1188.syncShadow());
+
+    CAP1188LedConfig config;
+    config.behavior[0] = sim.peekRegister(CAP1188_LED_BEHAVIOR_1_REG);
+    config.behavior[1] = sim.peekRegister(CAP1188_LED_BEHAVIOR_2_REG);
+    config.pulse1Period = sim.peekRegister(CAP1188_LED_PULSE_1_PERIOD_REG);
+    config.pulse2Period = sim.peekRegister(CAP1188_LED_PULSE_2_PERIOD_REG);
+    config.breathePeriod = sim.peekRegister(CAP1188_LED_BREATHE_PERIOD_REG);
+    config.pulseCounts = sim.peekRegister(CAP1188_LED_CONFIG_REG);
+    config.pulse1Duty = sim.peekRegister(CAP1188_LED_PULSE_1_DUTY_CYCLE_REG);
+    config.pulse2Duty = sim.peekRegister(CAP1188_LED_PULSE_2_DUTY_CYCLE_REG);
+    config.breatheDuty = sim.peekRegister(CAP1188_LED_BREATHE_DUTY_CYCLE_REG);
+    config.directDuty = sim.peekRegister(CAP1188_LED_DIRECT_DUTY_CYCLE_REG);
+    config.directRampRates = sim.peekRegister(CAP1188_LED_DIRECT_RAMP_RATES_REG);
+    config.offDelays = sim.peekRegister(CAP1188_LED_OFF_DELAY_REG);
+
+    sim.writes.clear();
+    CHECK(cap1188.applyLedConfig(config));
+    CHECK(sim.writes.empty());
+
+    // Adjacent registers share a burst
+    config.pulse2Period = 0x10;
+    config.breathePeriod = 0x30;
+    sim.writes.clear();
+    CHECK(cap1188.applyLedConfig(config));
+    CHECK(sim.writes.size() == 1);
+    CHECK(hasWrite(sim, CAP1188_LED_PULSE_2_PERIOD_REG, 2));
+    CHECK(sim.peekRegister(CAP1188_LED_BREATHE_PERIOD_REG) == 0x30);
+
+    config.behavior[1] = CAP1188_LED_BEHAVIORS(CAP1188_LED_BEHAVIOR_BREATHE, CAP1188_LED_BEHAVIOR_DIRECT, CAP1188_LED_BEHAVIOR_DIRECT, CAP1188_LED_BEHAVIOR_PULSE_1);
+    config.directDuty = 0x80;
+    sim.writes.clear();
+    CHECK(cap1188.applyLedConfig(config));
+    CHECK(sim.writes.size() == 2);
+    CHECK(hasWrite(sim, CAP1188_LED_BEHAVIOR_2_REG, 1));
+    CHECK(hasWrite(sim, CAP1188_LED_DIRECT_DUTY_CYCLE_REG, 1));
+    CHECK(sim.peekRegister(CAP1188_LED_BEHAVIOR_2_REG) == config.behavior[1]);
+}
+#endif
+
+/**
+ * @brief Checks initialisation modes: warm start keeps configured CAP1188 untouched, no-wait init returns during reset
+ * pulse and isReady() finishes it, cold init waits for the reset pulse
+ * @return void
+ */
+static void testInitModes()
+{
+    RecordingSim sim;
+    ResetPin resetPin(sim, 30);
+    hostSetPinDevice(&resetPin);
+
+    CAP1188 cold;
+    unsigned long start = millis();
+    cold.initTransport(sim, 30);
+    CHECK(millis() - start >= CAP1188_RESET_PULSE_MS);
+    CHECK(cold.isReady() && !cold.isWarmStart());
+    CHECK(resetPin.resets == 1);
+    CHECK(hostGetPin(30) == LOW);
+    CHECK(sim.peekRegister(CAP1188_SENSOR_INPUT_LED_LINKING_REG) == CAP1188_INIT_LED_LINKING);
+
+    // Configured CAP1188 is neither reset nor written, user settings are retained
+    sim.pokeRegister(CAP1188_SENSOR_INPUT_1_THRESHOLD_REG, 0x20);
+    sim.writes.clear();
+    CAP1188 warm;
+    warm.initTransport(sim, 30, CAP1188_INIT_WARM | CAP1188_INIT_NO_WAIT);
+    CHECK(warm.isReady() && warm.isWarmStart());
+    CHECK(resetPin.resets == 1);
+    CHECK(sim.writes.empty());
+    CHECK(sim.peekRegister(CAP1188_SENSOR_INPUT_1_THRESHOLD_REG) == 0x20);
+
+    // CAP1188 running with another configuration is initialised cold
+    sim.pokeRegister(CAP1188_SENSOR_INPUT_LED_LINKING_REG, 0x00);
+    CAP1188 reconfigured;
+    reconfigured.initTransport(sim, 30, CAP1188_INIT_WARM);
+    CHECK(reconfigured.isReady() && !reconfigured.isWarmStart());
+    CHECK(resetPin.resets == 2);
+    CHECK(sim.peekRegister(CAP1188_SENSOR_INPUT_1_THRESHOLD_REG) == 0x40);
+    CHECK(sim.peekRegister(CAP1188_SENSOR_INPUT_LED_LINKING_REG) == CAP1188_INIT_LED_LINKING);
+
+    // Without waiting RESET pin is left high and configuration is applied by isReady() once the pulse is over
+    sim.writes.clear();
+    CAP1188 noWait;
+    start = millis();
+    noWait.initTransport(sim, 30, CAP1188_INIT_NO_WAIT);
+    CHECK(millis() - start < CAP1188_RESET_PULSE_MS);
+    CHECK(hostGetPin(30) == HIGH);
+    CHECK(!noWait.isReady());
+    CHECK(sim.writes.empty());
+    while (!noWait.isReady() && millis() - start < 10 * CAP1188_RESET_PULSE_MS)
+    {
+        delay(1);
+    }
+    CHECK(noWait.isReady());
+    CHECK(millis() - start >= CAP1188_RESET_PULSE_MS);
+    CHECK(hostGetPin(30) == LOW);
+    CHECK(resetPin.resets == 3);
+    CHECK(hasWrite(sim, CAP1188_SENSOR_INPUT_LED_LINKING_REG));
+
+    hostSetPinDevice(NULL);
+}
+
+/**
+ * @brief Checks retries of a user supplied transport: status code, recovery within retry budget, backoff between retries
+ * @return void
+ */
+static void testRetries()
+{
+    FailingSim sim;
+    CAP1188 cap1188;
+    cap1188.initTransport(sim, CAP1188_NO_RESET_PIN);
+
+    cap1188.setRetryPolicy(0, 0);
+    sim.failingAccesses = 1;
+    CHECK(cap1188.getProductId() == 0);
+    CHECK(cap1188.getLastStatus() == CAP1188_STATUS_BUS_ERROR);
+    CHECK(cap1188.getProductId() == CAP1188_PRODUCT_ID);
+    CHECK(cap1188.getLastStatus() == CAP1188_STATUS_OK);
+
+    // Backoff doubles with every retry: 1ms + 2ms
+    cap1188.setRetryPolicy(2, 1000);
+    sim.failingAccesses = 2;
+    unsigned long start = micros();
+    CHECK(cap1188.setInterruptEnable(0x0F));
+    CHECK(micros() - start >= 3000);
+    CHECK(sim.peekRegister(CAP1188_INTERRUPT_ENABLE_REG) == 0x0F);
+    CHECK(sim.failingAccesses == 0);
+
+    sim.failingAccesses = 3;
+    CHECK(!cap1188.setInterruptEnable(0x01));
+    CHECK(cap1188.getLastStatus() == CAP1188_STATUS_BUS_ERROR);
+    CHECK(sim.peekRegister(CAP1188_INTERRUPT_ENABLE_REG) == 0x0F);
+}
+
+#if CAP1188_HAS_FEATURE(CAP1188_FEATURE_THRESHOLDS)
+// Simulator with a broken threshold register of input 6, which always keeps its power-on default
+class StuckThresholdSim : public CAP1188Sim{
+    public:
+        bool writeRegisters(uint8_t startAddress, const uint8_t *buff, uint8_t len)
+        {
+            CAP1188Sim::writeRegisters(startAddress, buff, len);
+            pokeRegister(CAP1188_SENSOR_INPUT_6_THRESHOLD_REG, 0x40);
+            return true;
+        }
+};
+
+/**
+ * @brief Checks setSensorInputThresholdAll(...): single write broadcast by BUT_LD_TH (set temporarily if it was cleared)
+ * and verification of all thresholds
+ * @return void
+ */
+static void testThresholdAll()
+{
+    RecordingSim sim;
+    CAP1188 cap1188;
+    cap1188.initTransport(sim, CAP1188_NO_RESET_PIN);
+    sim.writes.clear();
+    CHECK(cap1188.setSensorInputThresholdAll(0x20));
+    CHECK(sim.writes.size() == 1);
+    CHECK(hasWrite(sim, CAP1188_SENSOR_INPUT_1_THRESHOLD_REG, 1));
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        CHECK(sim.peekRegister(CAP1188_SENSOR_INPUT_1_THRESHOLD_REG + i) == 0x20);
+    }
+
+    // BUT_LD_TH is set for the broadcast and restored afterwards
+    sim.pokeRegister(CAPP1188_RECALIBRATION_CONFIGURATION_REG, 0x0A);
+    CHECK(cap1188.syncShadow());
+    CHECK(cap1188.setSensorInputThresholdAll(0x30));
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        CHECK(sim.peekRegister(CAP1188_SENSOR_INPUT_1_THRESHOLD_REG + i) == 0x30);
+    }
+    CHECK(sim.peekRegister(CAPP1188_RECALIBRATION_CONFIGURATION_REG) == 0x0A);
+
+    // Threshold, which did not take the value, fails verification
+    StuckThresholdSim stuck;
+    CAP1188 broken;
+    broken.initTransport(stuck, CAP1188_NO_RESET_PIN);
+    CHECK(!broken.setSensorInputThresholdAll(0x20));
+    CHECK(broken.setSensorInputThresholdAll(0x40));
+}
+#endif
+
+#if CAP1188_HAS_FEATURE(CAP1188_FEATURE_COUNTS)
+/**
+ * @brief Checks calibration snapshot: register blocks saved, configuration restored, only inputs drifted beyond
+ * tolerance (and not calibrating) are recalibrated
+ * @return void
+ */
+static void testCalibration()
+{
+    RecordingSim sim;
+    CAP1188 cap1188;
+    cap1188.initTransport(sim, CAP1188_NO_RESET_PIN);
+    const uint8_t baseCounts[8] = {100, 101, 102, 103, 104, 105, 106, 107};
+    sim.setBaseCounts(baseCounts);
+    const uint8_t calibration[10] = {0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x1B, 0xE4};
+    for (uint8_t i = 0; i < sizeof(calibration); i++)
+    {
+        sim.pokeRegister(CAP1188_SENSOR_INPUT_1_CALIBRATION_REG + i, calibration[i]);
+    }
+
+    CAP1188CalibrationSnapshot snapshot;
+    CHECK(sizeof(snapshot) == 33); // Register images only, no padding
+    CHECK(cap1188.saveCalibration(&snapshot));
+    CHECK(snapshot.version == CAP1188_CALIBRATION_SNAPSHOT_VERSION);
+    CHECK(snapshot.config[0] == sim.peekRegister(CAP1188_SENSITIVITY_CONTROL_REG));
+    CHECK(snapshot.config[5] == sim.peekRegister(CAP1188_AVERAGING_AND_SAMPLING_CONFIG_REG));
+    CHECK(snapshot.thresholds[0] == 0x40);
+    CHECK(memcmp(snapshot.baseCounts, baseCounts, sizeof(baseCounts)) == 0);
+    CHECK(memcmp(snapshot.calibration, calibration, sizeof(calibration)) == 0);
+
+    uint16_t calibrations[8];
+    CHECK(cap1188.getCalibrations(calibrations));
+    CHECK(calibrations[0] == (0x40 << 2 | 0x03) && calibrations[3] == (0x43 << 2 | 0x00) && calibrations[7] == (0x47 << 2 | 0x03));
+
+    // Changed configuration is written back, matching calibration needs no recalibration
+#if CAP1188_HAS_FEATURE(CAP1188_FEATURE_THRESHOLDS)
+    CHECK(cap1188.setSensorInputThresholdAll(0x10));
+    CHECK(cap1188.setSensitivity(CAP1188_SENSITIVITY_128X));
+#endif
+    sim.writes.clear();
+    CHECK(cap1188.restoreCalibration(snapshot));
+    CHECK(sim.peekRegister(CAP1188_SENSITIVITY_CONTROL_REG) == snapshot.config[0]);
+    CHECK(sim.peekRegister(CAP1188_SENSOR_INPUT_1_THRESHOLD_REG) == 0x40 && sim.peekRegister(CAP1188_SENSOR_INPUT_8_THRESHOLD_REG) == 0x40);
+    CHECK(!hasWrite(sim, CAP1188_CALIBRATION_ACTIVATE_REG));
+
+    // Drift within tolerance is accepted, only input 3 drifted beyond it
+    sim.pokeRegister(CAP1188_SENSOR_INPUT_1_CALIBRATION_REG, 0x40 + CAP1188_CALIBRATION_TOLERANCE / 4);
+    sim.pokeRegister(CAP1188_SENSOR_INPUT_3_CALIBRATION_REG, 0x42 + CAP1188_CALIBRATION_TOLERANCE / 4 + 1);
+    sim.writes.clear();
+    CHECK(cap1188.restoreCalibration(snapshot));
+    CHECK(sim.writes.size() == 1 && sim.writes[0].startAddress == CAP1188_CALIBRATION_ACTIVATE_REG && sim.writes[0].data == 0x04);
+
+    // Input, which is still calibrating, is not compared
+    sim.pokeRegister(CAP1188_CALIBRATION_ACTIVATE_REG, 0x04);
+    sim.writes.clear();
+    CHECK(cap1188.restoreCalibration(snapshot));
+    CHECK(sim.writes.empty());
+    sim.pokeRegister(CAP1188_CALIBRATION_ACTIVATE_REG, 0x00);
+
+    CAP1188CalibrationSnapshot other = snapshot;
+    other.version++;
+    CHECK(!cap1188.restoreCalibration(other));
+}
+#endif
+
+/**
+ * @brief Runs tests of this file
+ * @return void
+ */
+void runDriverTests()
+{
+    testApplyConfig();
+#if CAP1188_HAS_FEATURE(CAP1188_FEATURE_LED)
+    testApplyLedConfig();
+#endif
+    testInitModes();
+    testRetries();
+#if CAP1188_HAS_FEATURE(CAP1188_FEATURE_THRESHOLDS)
+    testThresholdAll();
+#endif
+#if CAP1188_HAS_FEATURE(CAP1188_FEATURE_COUNTS)
+    testCalibration();
+#endif
+}
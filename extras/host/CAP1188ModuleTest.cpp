@@ -0,0 +1,385 @@
+/*
+ * Host tests of modules built on top of the driver: CAP1188Gesture, CAP1188Governor, CAP1188Monitor, CAP1188Telemetry
+ */
+#include "HostTest.h"
+#include "HostDevices.h"
+#include "CAP1188.h"
+#include "CAP1188Gesture.h"
+#include "CAP1188Governor.h"
+#include "CAP1188Monitor.h"
+#include "CAP1188Telemetry.h"
+#include "CAP1188_reg.h"
+
+#if CAP1188_HAS_FEATURE(CAP1188_FEATURE_COUNTS)
+/**
+ * @brief Feeds the same sample of delta counts several times, 10ms apart
+ * @param gesture gesture engine
+ * @param deltas delta counts of inputs 1...8
+ * @param samples amount of samples
+ * @param now time of the next sample, advanced by samples fed
+ * @return void
+ */
+static void feedSamples(CAP1188Gesture &gesture, const int8_t deltas[8], uint8_t samples, uint32_t *now)
+{
+    for (uint8_t i = 0; i < samples; i++)
+    {
+        gesture.feed(deltas, *now);
+        *now += 10;
+    }
+}
+
+/**
+ * @brief Counts buffered events of a type and drops all buffered events
+ * @param gesture gesture engine
+ * @param type CAP1188_EVENT_...
+ * @param input expected input number of counted events
+ * @return amount of events of a type for the input
+ */
+static uint8_t drainEvents(CAP1188Gesture &gesture, uint8_t type, uint8_t input)
+{
+    uint8_t count = 0;
+    CAP1188Event event;
+    while (gesture.readEvent(&event))
+    {
+        if (event.type == type && event.input == input)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Checks CAP1188Gesture: debounced press and release, hold and repeat timing, slide to the adjacent input, update()
+ * reading delta counts of a device
+ * @return void
+ */
+static void testGesture()
+{
+    CAP1188Gesture gesture;
+    gesture.setTiming(500, 100, 150);
+    int8_t deltas[8] = {0};
+    uint32_t now = 1000;
+
+    // A single sample does not pass filtering and debouncing
+    deltas[0] = 64;
+    feedSamples(gesture, deltas, 1, &now);
+    CHECK(gesture.eventsAvailable() == 0);
+    feedSamples(gesture, deltas, 9, &now);
+    CHECK(gesture.getPressed() == 0x01);
+    CAP1188Event event;
+    CHECK(gesture.readEvent(&event));
+    CHECK(event.type == CAP1188_EVENT_PRESS && event.input == 1);
+    CHECK(!gesture.readEvent(&event));
+    uint32_t pressTime = event.timestamp;
+
+    // Hold after 500ms, then repeat every 100ms
+    feedSamples(gesture, deltas, (pressTime + 710 - now) / 10, &now);
+    CHECK(gesture.eventsAvailable() == 3);
+    CHECK(gesture.readEvent(&event) && event.type == CAP1188_EVENT_HOLD && event.timestamp == pressTime + 500);
+    CHECK(drainEvents(gesture, CAP1188_EVENT_REPEAT, 1) == 2);
+
+    deltas[0] = 0;
+    feedSamples(gesture, deltas, 10, &now);
+    CHECK(gesture.getPressed() == 0x00);
+    CHECK(drainEvents(gesture, CAP1188_EVENT_RELEASE, 1) == 1);
+
+    // Press of the adjacent input shortly after release is a slide
+    deltas[1] = 64;
+    feedSamples(gesture, deltas, 10, &now);
+    CHECK(gesture.getPressed() == 0x02);
+    CHECK(gesture.readEvent(&event) && event.type == CAP1188_EVENT_PRESS && event.input == 2);
+    CHECK(gesture.readEvent(&event) && event.type == CAP1188_EVENT_SLIDE_UP && event.input == 2);
+    gesture.reset();
+    CHECK(gesture.getPressed() == 0x00 && gesture.eventsAvailable() == 0);
+
+    // Without a device there is nothing to update from
+    CHECK(!gesture.update());
+    CAP1188Sim sim;
+    CAP1188 cap1188;
+    cap1188.initTransport(sim, CAP1188_NO_RESET_PIN);
+    const int8_t touched[8] = {0, 0, 100, 0, 0, 0, 0, -100};
+    sim.setDeltaCounts(touched);
+    gesture.begin(cap1188);
+    for (uint8_t i = 0; i < 10; i++)
+    {
+        CHECK(gesture.update());
+    }
+    CHECK(gesture.getPressed() == 0x04);
+}
+#endif
+
+#if CAP1188_HAS_FEATURE(CAP1188_FEATURE_STANDBY) && CAP1188_HAS_FEATURE(CAP1188_FEATURE_THRESHOLDS)
+/**
+ * @brief Checks CAP1188Governor: profiles written by begin(...), standby after idle timeout, active again on touch
+ * @return void
+ */
+static void testGovernor()
+{
+    FailingSim sim;
+    CAP1188 cap1188;
+    cap1188.initTransport(sim, CAP1188_NO_RESET_PIN);
+    cap1188.setRetryPolicy(0, 0);
+    CAP1188Governor governor;
+    governor.setIdleTimeout(20);
+    CHECK(governor.begin(cap1188));
+    CHECK(!governor.isStandby());
+    CHECK(!(sim.peekRegister(CAP1188_MAIN_CONTROL_REG) & CAP1188_MAIN_CONTROL_STBY_BIT));
+    CHECK(sim.peekRegister(CAP1188_STANDBY_CHANNEL_REG) == 0xFF);
+    uint8_t samples, samplingTime, cycleTime;
+    CHECK(cap1188.getAveragingAndSamplingConfig(&samples, &samplingTime, &cycleTime));
+    CHECK(samples == CAP1188_SAMPLES_PER_MEASUREMENT_2 && samplingTime == CAP1188_SAMPLING_TIME_1_28ms && cycleTime == CAP1188_CYCLE_TIME_35ms);
+    CHECK(governor.getPollInterval() == 35);
+
+    // Idle timeout is not over yet
+    CHECK(governor.update(0x00));
+    CHECK(!governor.isStandby());
+    delay(25);
+    CHECK(governor.update(0x00));
+    CHECK(governor.isStandby());
+    CHECK(sim.peekRegister(CAP1188_MAIN_CONTROL_REG) & CAP1188_MAIN_CONTROL_STBY_BIT);
+    CHECK(governor.getPollInterval() == 140);
+
+    CHECK(governor.update(0x01));
+    CHECK(!governor.isStandby());
+    CHECK(!(sim.peekRegister(CAP1188_MAIN_CONTROL_REG) & CAP1188_MAIN_CONTROL_STBY_BIT));
+
+    // Sensor inputs are read from the device
+    delay(25);
+    CHECK(governor.update());
+    CHECK(governor.isStandby());
+    sim.setTouches(0x02);
+    CHECK(governor.update());
+    CHECK(!governor.isStandby());
+
+    // Failed read is not taken for idle inputs
+    sim.failReads = true;
+    delay(25);
+    CHECK(!governor.update());
+    CHECK(!governor.isStandby());
+}
+#endif
+
+#if CAP1188_HAS_FEATURE(CAP1188_FEATURE_COUNTS)
+// Simulator, which models calibration taking time: inputs written to CALIBRATION ACTIVATE REGISTER finish calibrating
+// when the register is read next time, which also updates their base counts
+class CalibratingSim : public CAP1188Sim{
+    public:
+        CalibratingSim() : calibratedBaseCount(0), _calibrating(0) {}
+        bool readRegisters(uint8_t startAddress, uint8_t *buff, uint8_t len)
+        {
+            if (startAddress <= CAP1188_CALIBRATION_ACTIVATE_REG && startAddress + len > CAP1188_CALIBRATION_ACTIVATE_REG)
+            {
+                for (uint8_t i = 0; i < 8; i++)
+                {
+                    if (_calibrating & (1 << i))
+                    {
+                        pokeRegister(CAP1188_SENSOR_INPUT_1_BASE_COUNT_REG + i, calibratedBaseCount);
+                    }
+                }
+                _calibrating = 0;
+            }
+            return CAP1188Sim::readRegisters(startAddress, buff, len);
+        }
+        bool writeRegisters(uint8_t startAddress, const uint8_t *buff, uint8_t len)
+        {
+            if (startAddress <= CAP1188_CALIBRATION_ACTIVATE_REG && startAddress + len > CAP1188_CALIBRATION_ACTIVATE_REG)
+            {
+                _calibrating |= buff[CAP1188_CALIBRATION_ACTIVATE_REG - startAddress];
+            }
+            return CAP1188Sim::writeRegisters(startAddress, buff, len);
+        }
+        uint8_t calibratedBaseCount; // Base count of inputs after calibration
+
+    private:
+        uint8_t _calibrating;
+};
+
+/**
+ * @brief Checks CAP1188Monitor: only drifted or noisy inputs, which are not touched, are recalibrated, and references are
+ * captured from base counts read after calibration finished
+ * @return void
+ */
+static void testMonitor()
+{
+    CalibratingSim sim;
+    CAP1188 cap1188;
+    cap1188.initTransport(sim, CAP1188_NO_RESET_PIN);
+    uint8_t baseCounts[8] = {100, 100, 100, 100, 100, 100, 100, 100};
+    sim.setBaseCounts(baseCounts);
+    sim.calibratedBaseCount = 100;
+    CAP1188Monitor monitor;
+    CHECK(!monitor.update());
+    monitor.setLimits(10, 3);
+    CHECK(monitor.begin(cap1188));
+    CHECK(monitor.update());
+    CHECK(monitor.getRecalibrationCount() == 0);
+
+    baseCounts[2] = 115;
+    sim.setBaseCounts(baseCounts);
+    CHECK(monitor.update());
+    CHECK(monitor.getDrift(3) == 15);
+    CHECK(monitor.getRecalibrationCount() == 1);
+    CHECK(monitor.getCalibratingInputs() == 0x04);
+
+    // Calibration finished, so reference is taken from the base count after calibration and nothing drifts any more
+    CHECK(monitor.update());
+    CHECK(monitor.getCalibratingInputs() == 0x00);
+    CHECK(monitor.getDrift(3) == 0);
+    CHECK(monitor.update());
+    CHECK(monitor.getRecalibrationCount() == 1);
+
+    // Touched input is never recalibrated
+    baseCounts[2] = 100;
+    baseCounts[4] = 80;
+    sim.setBaseCounts(baseCounts);
+    sim.setTouches(0x10);
+    CHECK(monitor.update());
+    CHECK(monitor.getSensorInputs() == 0x10);
+    CHECK(monitor.getRecalibrationCount() == 1);
+    sim.setTouches(0x00);
+    cap1188.getSensorInputs();
+    cap1188.getSensorInputs();
+    CHECK(monitor.update());
+    CHECK(monitor.getRecalibrationCount() == 2);
+    CHECK(monitor.update());
+
+    // Noise flag has to persist for noise limit updates
+    sim.pokeRegister(CAP1188_NOISE_FLAG_STATUS_REG, 0x01);
+    CHECK(monitor.update());
+    CHECK(monitor.update());
+    CHECK(monitor.getRecalibrationCount() == 2);
+    CHECK(monitor.update());
+    CHECK(monitor.getNoiseFlags() == 0x01);
+    CHECK(monitor.getRecalibrationCount() == 3);
+    CHECK(monitor.getCalibratingInputs() == 0x01);
+}
+
+// Telemetry output collecting everything written to it
+class CapturePrint : public Print{
+    public:
+        size_t write(uint8_t data)
+        {
+            bytes.push_back(data);
+            return 1;
+        }
+        std::vector<uint8_t> bytes;
+};
+
+// Telemetry callback collecting emitted halves of the buffer
+struct CaptureCallback
+{
+    uint8_t calls;
+    std::vector<uint8_t> bytes;
+};
+
+/**
+ * @brief Collects an emitted half of telemetry buffer (CAP1188TelemetryCallback)
+ * @param arg CaptureCallback
+ * @param frames frames emitted
+ * @param len amount of bytes
+ * @return void
+ */
+static void captureFrames(void *arg, const uint8_t *frames, uint16_t len)
+{
+    CaptureCallback *capture = (CaptureCallback *)arg;
+    capture->calls++;
+    capture->bytes.insert(capture->bytes.end(), frames, frames + len);
+}
+
+/**
+ * @brief Checks CAP1188Telemetry: frame layout and checksum, double buffer emitted per filled half, base counts refreshed
+ * every CAP1188_TELEMETRY_BASE_COUNT_DIVIDER frames, single burst per frame otherwise
+ * @return void
+ */
+static void testTelemetry()
+{
+    CAP1188Sim sim;
+    CAP1188 cap1188;
+    cap1188.initTransport(sim, CAP1188_NO_RESET_PIN);
+    const int8_t deltas[8] = {1, -2, 3, -4, 5, -6, 7, -8};
+    sim.setDeltaCounts(deltas);
+    uint8_t baseCounts[8] = {100, 101, 102, 103, 104, 105, 106, 107};
+    sim.setBaseCounts(baseCounts);
+    sim.pokeRegister(CAP1188_NOISE_FLAG_STATUS_REG, 0x80);
+    sim.setTouches(0x03);
+
+    CAP1188Telemetry telemetry;
+    uint8_t buffer[4 * CAP1188_TELEMETRY_FRAME_SIZE + 5];
+    CaptureCallback capture = {0, std::vector<uint8_t>()};
+    CHECK(!telemetry.begin(cap1188, buffer, 2 * CAP1188_TELEMETRY_FRAME_SIZE - 1, captureFrames, &capture));
+    CHECK(!telemetry.sample());
+    CHECK(telemetry.begin(cap1188, buffer, sizeof(buffer), captureFrames, &capture));
+    CHECK(telemetry.getFramesPerBuffer() == 2);
+
+    // First frame reads base counts too, the second one only status and delta counts
+    sim.resetCounters();
+    CHECK(telemetry.sample());
+    CHECK(sim.getTransactions() == 4);
+    CHECK(capture.calls == 0);
+    baseCounts[0] = 90;
+    sim.setBaseCounts(baseCounts);
+    sim.resetCounters();
+    CHECK(telemetry.sample());
+    CHECK(sim.getTransactions() == 2);
+    CHECK(capture.calls == 1 && capture.bytes.size() == 2 * CAP1188_TELEMETRY_FRAME_SIZE);
+
+    const uint8_t *frame = capture.bytes.data();
+    CHECK(frame[0] == CAP1188_TELEMETRY_SYNC_1 && frame[1] == CAP1188_TELEMETRY_SYNC_2);
+    CHECK(frame[2] == 0 && frame[CAP1188_TELEMETRY_FRAME_SIZE + 2] == 1);
+    CHECK(frame[7] == sim.peekRegister(CAP1188_GENERAL_STATUS_REG));
+    CHECK(frame[8] == 0x03);
+    CHECK(frame[9] == 0x80);
+    CHECK(memcmp(&frame[10], deltas, 8) == 0);
+    CHECK(frame[18] == 100 && frame[CAP1188_TELEMETRY_FRAME_SIZE + 18] == 100);
+    bool checksums = true;
+    for (uint8_t f = 0; f < 2; f++)
+    {
+        uint8_t checksum = 0;
+        for (uint8_t i = 2; i < CAP1188_TELEMETRY_FRAME_SIZE - 1; i++)
+        {
+            checksum += frame[f * CAP1188_TELEMETRY_FRAME_SIZE + i];
+        }
+        checksums = checksums && frame[(f + 1) * CAP1188_TELEMETRY_FRAME_SIZE - 1] == checksum;
+    }
+    CHECK(checksums);
+
+    // Base counts are read again within every CAP1188_TELEMETRY_BASE_COUNT_DIVIDER-th frame
+    for (uint8_t i = 2; i <= CAP1188_TELEMETRY_BASE_COUNT_DIVIDER; i++)
+    {
+        CHECK(telemetry.sample());
+    }
+    telemetry.flush();
+    size_t frames = capture.bytes.size() / CAP1188_TELEMETRY_FRAME_SIZE;
+    CHECK(frames == CAP1188_TELEMETRY_BASE_COUNT_DIVIDER + 1);
+    CHECK(capture.bytes[(CAP1188_TELEMETRY_BASE_COUNT_DIVIDER - 1) * CAP1188_TELEMETRY_FRAME_SIZE + 18] == 100);
+    CHECK(capture.bytes[CAP1188_TELEMETRY_BASE_COUNT_DIVIDER * CAP1188_TELEMETRY_FRAME_SIZE + 18] == 90);
+
+    // Print output gets the same frames
+    CapturePrint print;
+    CHECK(telemetry.begin(cap1188, buffer, sizeof(buffer), print));
+    CHECK(telemetry.sample());
+    CHECK(print.bytes.empty());
+    CHECK(telemetry.sample());
+    CHECK(print.bytes.size() == 2 * CAP1188_TELEMETRY_FRAME_SIZE);
+    CHECK(print.bytes[0] == CAP1188_TELEMETRY_SYNC_1 && print.bytes[2] == 0);
+}
+#endif
+
+/**
+ * @brief Runs tests of this file
+ * @return void
+ */
+void runModuleTests()
+{
+#if CAP1188_HAS_FEATURE(CAP1188_FEATURE_COUNTS)
+    testGesture();
+#endif
+#if CAP1188_HAS_FEATURE(CAP1188_FEATURE_STANDBY) && CAP1188_HAS_FEATURE(CAP1188_FEATURE_THRESHOLDS)
+    testGovernor();
+#endif
+#if CAP1188_HAS_FEATURE(CAP1188_FEATURE_COUNTS)
+    testMonitor();
+    testTelemetry();
+#endif
+}
@@ -0,0 +1,204 @@
+/*
+ * Host tests of CAP1188Sim and driver paths running directly on it: register model, transaction counts, CAP1188Bus, ALERT.
+ */
+#include "HostTest.h"
+#include "HostDevices.h"
+#include "CAP1188.h"
+#include "CAP1188Sim.h"
+#include "CAP1188Bus.h"
+#include "CAP1188_reg.h"
+
+/**
+ * @brief Checks that product ID is read over the transport
+ * @return void
+ */
+static void testProductId()
+{
+    CAP1188Sim sim;
+    CAP1188 cap1188;
+    cap1188.initTransport(sim, CAP1188_NO_RESET_PIN);
+    CHECK(cap1188.isReady());
+    CHECK(cap1188.getProductId() == CAP1188_PRODUCT_ID);
+    CHECK(cap1188.getLastStatus() == CAP1188_STATUS_OK);
+}
+
+#if CAP1188_HAS_FEATURE(CAP1188_FEATURE_THRESHOLDS)
+/**
+ * @brief Checks that threshold of input 1 is broadcast to all inputs (BUT_LD_TH is set by default)
+ * @return void
+ */
+static void testThresholdBroadcast()
+{
+    CAP1188Sim sim;
+    CAP1188 cap1188;
+    cap1188.initTransport(sim, CAP1188_NO_RESET_PIN);
+    CHECK(cap1188.setSensorInputThreshold(1, 0x20));
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        CHECK(sim.peekRegister(CAP1188_SENSOR_INPUT_1_THRESHOLD_REG + i) == 0x20);
+    }
+
+    uint8_t thresholds[8];
+    CHECK(cap1188.getSensorInputThresholds(thresholds));
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        CHECK(thresholds[i] == 0x20);
+    }
+}
+#endif
+
+/**
+ * @brief Checks that touch latches sensor inputs and INT bit until driver clears it
+ * @return void
+ */
+static void testInterruptLatch()
+{
+    CAP1188Sim sim;
+    CAP1188 cap1188;
+    cap1188.initTransport(sim, CAP1188_NO_RESET_PIN);
+
+    sim.setTouches(0x05);
+    CHECK(sim.peekRegister(CAP1188_MAIN_CONTROL_REG) & CAP1188_MAIN_CONTROL_INT_BIT);
+    // Released input stays latched until INT is cleared
+    sim.setTouches(0x04);
+    CHECK(sim.peekRegister(CAP1188_SENSOR_INPUT_STATUS_REG) == 0x05);
+
+    CHECK(cap1188.getSensorInputs() == 0x05);
+    CHECK(!(sim.peekRegister(CAP1188_MAIN_CONTROL_REG) & CAP1188_MAIN_CONTROL_INT_BIT));
+    CHECK(sim.peekRegister(CAP1188_SENSOR_INPUT_STATUS_REG) == 0x04);
+
+    sim.setTouches(0x00);
+    CHECK(cap1188.getSensorInputs() == 0x04);
+    CHECK(cap1188.getSensorInputs() == 0x00);
+}
+
+/**
+ * @brief Checks amount of bus transactions of getSensorInputs() for both bus models
+ * @return void
+ */
+static void testTransactionCounts()
+{
+    CAP1188Sim sim;
+    CAP1188 cap1188;
+    cap1188.initTransport(sim, CAP1188_NO_RESET_PIN);
+
+    // I2C: register read is a write of register address and a repeated start read, INT clear is a single write
+    sim.resetCounters();
+    CHECK(cap1188.getSensorInputs() == 0x00);
+    CHECK(sim.getTransactions() == 2);
+
+    // First INT clear has to read MAIN CONTROL into shadow register file, later ones are only a write
+    sim.setTouches(0x01);
+    sim.resetCounters();
+    CHECK(cap1188.getSensorInputs() == 0x01);
+    CHECK(sim.getTransactions() == 5);
+
+    sim.setTouches(0x00);
+    sim.setTouches(0x01);
+    sim.resetCounters();
+    CHECK(cap1188.getSensorInputs() == 0x01);
+    CHECK(sim.getTransactions() == 3);
+
+    // SPI: every access is a single CS frame
+    sim.setBusModel(CAP1188_SIM_BUS_SPI, 1000000);
+    sim.setTouches(0x02);
+    sim.resetCounters();
+    CHECK(cap1188.getSensorInputs() == 0x03);
+    CHECK(sim.getTransactions() == 2);
+    CHECK(sim.getBusTimeUs() > 0);
+}
+
+/**
+ * @brief Checks that CAP1188Bus keeps last known sensor inputs of a device, which fails to be read
+ * @return void
+ */
+static void testBusReadError()
+{
+    FailingSim sim1, sim2;
+    CAP1188 cap1188_1, cap1188_2;
+    cap1188_1.initTransport(sim1, CAP1188_NO_RESET_PIN);
+    cap1188_2.initTransport(sim2, CAP1188_NO_RESET_PIN);
+    cap1188_1.setRetryPolicy(0, 0);
+    CAP1188Bus bus;
+    CHECK(bus.addDevice(cap1188_1));
+    CHECK(bus.addDevice(cap1188_2));
+
+    sim1.setTouches(0x01);
+    sim2.setTouches(0x02);
+    CHECK(bus.getTouchMap() == 0x0201);
+
+    sim1.setTouches(0x00);
+    sim1.setTouches(0x04);
+    sim1.failReads = true;
+    CHECK(bus.getTouchMap() == 0x0201);
+    sim1.failReads = false;
+    // Released input 1 stays latched until INT is cleared
+    CHECK(bus.getTouchMap() == 0x0205);
+}
+
+/**
+ * @brief Checks interrupt driven mode: ALERT interrupt of every device reaches its own object, slots are limited and reused
+ * @return void
+ */
+static void testAlert()
+{
+    CAP1188Sim sims[CAP1188_MAX_ALERT_DEVICES + 1];
+    CAP1188 devices[CAP1188_MAX_ALERT_DEVICES + 1];
+    for (uint8_t i = 0; i <= CAP1188_MAX_ALERT_DEVICES; i++)
+    {
+        devices[i].initTransport(sims[i], CAP1188_NO_RESET_PIN);
+    }
+    for (uint8_t i = 0; i < CAP1188_MAX_ALERT_DEVICES; i++)
+    {
+        CHECK(devices[i].attachAlert(10 + i));
+    }
+    CHECK(!devices[CAP1188_MAX_ALERT_DEVICES].attachAlert(10 + CAP1188_MAX_ALERT_DEVICES));
+
+    sims[2].setTouches(0x08);
+    hostRaiseInterrupt(12);
+    CHECK(devices[2].isAlertPending());
+    CHECK(!devices[1].isAlertPending());
+    CHECK(devices[2].processAlert());
+    CHECK(!(sims[2].peekRegister(CAP1188_MAIN_CONTROL_REG) & CAP1188_MAIN_CONTROL_INT_BIT));
+    CAP1188Event event;
+    CHECK(devices[2].readEvent(&event));
+    CHECK(event.type == CAP1188_EVENT_PRESS && event.input == 4);
+    CHECK(!devices[2].readEvent(&event));
+    CHECK(devices[2].getLastSensorInputs() == 0x08);
+
+    // Freed slot is taken by the next device
+    devices[0].detachAlert();
+    hostRaiseInterrupt(10);
+    CHECK(!devices[0].isAlertPending());
+    CHECK(devices[CAP1188_MAX_ALERT_DEVICES].attachAlert(10 + CAP1188_MAX_ALERT_DEVICES));
+    hostRaiseInterrupt(10 + CAP1188_MAX_ALERT_DEVICES);
+    CHECK(devices[CAP1188_MAX_ALERT_DEVICES].isAlertPending());
+
+    // ALERT already asserted while attaching is not missed
+    devices[1].detachAlert();
+    hostSetPin(20, LOW);
+    CHECK(devices[0].attachAlert(20));
+    CHECK(devices[0].isAlertPending());
+    hostSetPin(20, HIGH);
+
+    for (uint8_t i = 0; i <= CAP1188_MAX_ALERT_DEVICES; i++)
+    {
+        devices[i].detachAlert();
+    }
+}
+
+/**
+ * @brief Runs tests of this file
+ * @return void
+ */
+void runSimTests()
+{
+    testProductId();
+#if CAP1188_HAS_FEATURE(CAP1188_FEATURE_THRESHOLDS)
+    testThresholdBroadcast();
+#endif
+    testInterruptLatch();
+    testTransactionCounts();
+    testBusReadError();
+    testAlert();
+}
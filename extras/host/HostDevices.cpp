@@ -0,0 +1,376 @@
+#include "HostDevices.h"
+
+/**
+ * @brief Instantiates CAP1188 on I2C bus
+ * @param sim registers of CAP1188
+ * @param address I2C address the device responds to
+ */
+SimI2CDevice::SimI2CDevice(CAP1188Sim &sim, uint8_t address) : failingTransmissions(0), failResult(2), shortReads(0), transmissions(0),
+                                                              _sim(sim), _address(address), _pointer(0)
+{
+}
+
+/**
+ * @brief Receives a write transmission (HostI2CDevice)
+ * @param address I2C address of a transmission
+ * @param data bytes written (register address followed by data)
+ * @param len amount of bytes written
+ * @param sendStop false if bus is kept for a repeated start
+ * @return Wire result of a transmission
+ */
+uint8_t SimI2CDevice::write(uint8_t address, const uint8_t *data, uint8_t len, bool sendStop)
+{
+    if (address != _address)
+    {
+        return 2;
+    }
+    transmissions++;
+    if (failingTransmissions)
+    {
+        failingTransmissions--;
+        return failResult;
+    }
+    if (len == 0)
+    {
+        return 0;
+    }
+    _pointer = data[0];
+    if (len > 1)
+    {
+        _sim.writeRegisters(_pointer, data + 1, len - 1);
+        _pointer += len - 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Receives a read transmission (HostI2CDevice)
+ * @param address I2C address of a transmission
+ * @param buff buffer to receive register contents in to
+ * @param len amount of bytes requested
+ * @param sendStop false if bus is kept for a repeated start
+ * @return amount of bytes read
+ */
+uint8_t SimI2CDevice::read(uint8_t address, uint8_t *buff, uint8_t len, bool sendStop)
+{
+    if (address != _address)
+    {
+        return 0;
+    }
+    transmissions++;
+    if (failingTransmissions)
+    {
+        failingTransmissions--;
+        return 0;
+    }
+    if (shortReads && len)
+    {
+        shortReads--;
+        len--;
+    }
+    _sim.readRegisters(_pointer, buff, len);
+    _pointer += len;
+    return len;
+}
+
+/**
+ * @brief Instantiates SPI command decoder with unknown register pointer
+ * @param sim registers of CAP1188
+ */
+SimSPIProtocol::SimSPIProtocol(CAP1188Sim &sim) : frames(0), setPointerCommands(0), interfaceResets(0), unknownPointerAccesses(0),
+                                                 _sim(sim), _pointer(HOST_POINTER_UNKNOWN), _operandOf(0), _resetCommands(0)
+{
+}
+
+/**
+ * @brief Starts decoding of a new CS frame (command state does not survive CS deassertion, register pointer does)
+ * @return void
+ */
+void SimSPIProtocol::beginFrame()
+{
+    frames++;
+    _operandOf = 0;
+    _resetCommands = 0;
+}
+
+/**
+ * @brief Decodes a byte sent by the driver
+ * @param data byte sent by the driver
+ * @param readData receives register content, which CAP1188 sends during the next byte (only set for 0x7F)
+ * @return true if a byte was 0x7F (read data) command, false otherwise
+ */
+bool SimSPIProtocol::receive(uint8_t data, uint8_t *readData)
+{
+    uint8_t operandOf = _operandOf;
+    _operandOf = 0;
+    if (operandOf == 0x7D)
+    {
+        _pointer = data;
+        return false;
+    }
+    if (operandOf == 0x7E)
+    {
+        access(false, data);
+        return false;
+    }
+
+    _resetCommands = data == 0x7A ? _resetCommands + 1 : 0;
+    switch (data)
+    {
+    case 0x7D:
+        setPointerCommands++;
+        _operandOf = data;
+        return false;
+
+    case 0x7E:
+        _operandOf = data;
+        return false;
+
+    case 0x7F:
+        *readData = access(true, 0);
+        return true;
+
+    case 0x7A:
+        if (_resetCommands == 2)
+        {
+            _resetCommands = 0;
+            interfaceResets++;
+            _pointer = HOST_POINTER_UNKNOWN;
+        }
+        return false;
+
+    default:
+        // Dummy byte
+        return false;
+    }
+}
+
+/**
+ * @brief Reads or writes a register pointed by register pointer, then increments register pointer
+ * @param read true to read, false to write
+ * @param data data to write
+ * @return register content read
+ */
+uint8_t SimSPIProtocol::access(bool read, uint8_t data)
+{
+    if (_pointer == HOST_POINTER_UNKNOWN)
+    {
+        unknownPointerAccesses++;
+        return 0xFF;
+    }
+    if (read)
+    {
+        _sim.readRegisters(_pointer, &data, 1);
+    }
+    else
+    {
+        _sim.writeRegisters(_pointer, &data, 1);
+    }
+    // Behaviour of register pointer beyond last register is not documented
+    _pointer = _pointer < 0xFF ? _pointer + 1 : HOST_POINTER_UNKNOWN;
+    return data;
+}
+
+/**
+ * @brief Instantiates CAP1188 on SPI 4-wire bus
+ * @param sim registers of CAP1188
+ * @param csPin CS pin of CAP1188
+ */
+SimSPIDevice::SimSPIDevice(CAP1188Sim &sim, uint8_t csPin) : SimSPIProtocol(sim), unselectedFrames(0), _csPin(csPin)
+{
+}
+
+/**
+ * @brief Transfers a CS frame (HostSPIDevice)
+ * @param data bytes sent by the driver
+ * @param out buffer to receive bytes sent by CAP1188 in to (may be the same as data)
+ * @param len amount of bytes
+ * @return void
+ */
+void SimSPIDevice::transfer(const uint8_t *data, uint8_t *out, uint32_t len)
+{
+    if (hostGetPin(_csPin) != LOW)
+    {
+        unselectedFrames++;
+        if (out)
+        {
+            memset(out, 0xFF, len);
+        }
+        return;
+    }
+    beginFrame();
+    lastFrame.assign(data, data + len);
+    uint8_t next = 0xFF; // Sent by CAP1188 during the next byte
+    for (uint32_t i = 0; i < len; i++)
+    {
+        uint8_t command = data[i];
+        if (out)
+        {
+            out[i] = next;
+        }
+        next = 0xFF;
+        receive(command, &next);
+    }
+}
+
+/**
+ * @brief Instantiates CAP1188 on SPI 3-wire bus
+ * @param sim registers of CAP1188
+ * @param csPin CS pin of CAP1188
+ * @param sckPin SPI_CLK pin of CAP1188
+ * @param sdioPin SPI_MOSI (SDIO) pin of CAP1188
+ */
+Sim3WireDevice::Sim3WireDevice(CAP1188Sim &sim, uint8_t csPin, uint8_t sckPin, uint8_t sdioPin) : SimSPIProtocol(sim), contentions(0), floatingBits(0),
+                                                                                              directionSwitches(0), _csPin(csPin), _sckPin(sckPin),
+                                                                                              _sdioPin(sdioPin), _selected(false), _sck(LOW),
+                                                                                              _sdioMode(INPUT), _shift(0), _bits(0), _output(false),
+                                                                                              _outData(0), _outBit(-1)
+{
+}
+
+/**
+ * @brief Follows pins driven by the driver (HostPinDevice)
+ * @param pin pin, mode or level of which was set
+ * @return void
+ */
+void Sim3WireDevice::pinChanged(uint8_t pin)
+{
+    if (pin == _sdioPin)
+    {
+        uint8_t mode = hostGetPinMode(_sdioPin) == OUTPUT ? OUTPUT : INPUT;
+        if (mode != _sdioMode)
+        {
+            directionSwitches++;
+            _sdioMode = mode;
+        }
+        if (mode == OUTPUT && _output)
+        {
+            contentions++;
+        }
+    }
+    else if (pin == _csPin)
+    {
+        bool selected = hostGetPin(_csPin) == LOW;
+        if (selected && !_selected)
+        {
+            beginFrame();
+            _bits = 0;
+        }
+        _selected = selected;
+        _output = false;
+    }
+    else if (pin == _sckPin && hostGetPin(_sckPin) != _sck)
+    {
+        _sck = hostGetPin(_sckPin);
+        if (!_selected)
+        {
+            return;
+        }
+        if (_sck == HIGH)
+        {
+            // Rising edge: CAP1188 samples SDIO, or presents the next bit it sends
+            if (_output)
+            {
+                if (_sdioMode == OUTPUT)
+                {
+                    contentions++;
+                }
+                _outBit++;
+                return;
+            }
+            if (_sdioMode != OUTPUT)
+            {
+                floatingBits++;
+            }
+            _shift = (_shift << 1) | hostGetPin(_sdioPin);
+            if (++_bits == 8)
+            {
+                _bits = 0;
+                if (receive(_shift, &_outData))
+                {
+                    // CAP1188 takes over SDIO after falling edge of the last command bit
+                    _output = true;
+                    _outBit = -1;
+                }
+            }
+        }
+        else if (_output && _outBit == 7)
+        {
+            _output = false;
+        }
+    }
+}
+
+/**
+ * @brief Returns level of SDIO while CAP1188 drives it (HostPinDevice)
+ * @param pin pin read by the driver
+ * @return level of a pin, -1 if CAP1188 does not drive it
+ */
+int Sim3WireDevice::pinLevel(uint8_t pin)
+{
+    if (pin != _sdioPin || !_output)
+    {
+        return -1;
+    }
+    return (_outData >> (7 - (_outBit < 0 ? 0 : _outBit))) & 0x01;
+}
+
+/**
+ * @brief Instantiates a simulator, which does not fail until requested
+ */
+FailingSim::FailingSim() : failReads(false), failingAccesses(0)
+{
+}
+
+/**
+ * @brief Reads registers unless a failure is requested (CAP1188Transport)
+ * @param startAddress first register address to read from
+ * @param buff buffer to receive register contents in to
+ * @param len amount of registers to read
+ * @return true on success, false on a requested failure
+ */
+bool FailingSim::readRegisters(uint8_t startAddress, uint8_t *buff, uint8_t len)
+{
+    return !fail(true) && CAP1188Sim::readRegisters(startAddress, buff, len);
+}
+
+/**
+ * @brief Writes registers unless a failure is requested (CAP1188Transport)
+ * @param startAddress first register address to write to
+ * @param buff buffer with register contents to write
+ * @param len amount of registers to write
+ * @return true on success, false on a requested failure
+ */
+bool FailingSim::writeRegisters(uint8_t startAddress, const uint8_t *buff, uint8_t len)
+{
+    return !fail(false) && CAP1188Sim::writeRegisters(startAddress, buff, len);
+}
+
+/**
+ * @brief Decides if an access fails
+ * @param read true for reads, false for writes
+ * @return true if access has to fail
+ */
+bool FailingSim::fail(bool read)
+{
+    if (failingAccesses)
+    {
+        failingAccesses--;
+        return true;
+    }
+    return read && failReads;
+}
+
+/**
+ * @brief Records and performs a write (CAP1188Transport)
+ * @param startAddress first register address to write to
+ * @param buff buffer with register contents to write
+ * @param len amount of registers to write
+ * @return true
+ */
+bool RecordingSim::writeRegisters(uint8_t startAddress, const uint8_t *buff, uint8_t len)
+{
+    Write write = {startAddress, len, buff[0]};
+    writes.push_back(write);
+    return CAP1188Sim::writeRegisters(startAddress, buff, len);
+}
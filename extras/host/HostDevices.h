@@ -0,0 +1,116 @@
+#ifndef _CAP1188_HOST_DEVICES_H_
+#define _CAP1188_HOST_DEVICES_H_
+
+// Bus level models of CAP1188 used by host tests. They decode what the driver puts on the bus (I2C transmissions,
+// SPI 4-wire frames, SPI 3-wire bit-banged pins) and access registers of a CAP1188Sim, so framing of the driver is checked
+// against the protocol of CAP1188 instead of being trusted
+
+#include <vector>
+#include <Arduino.h>
+#include <Wire.h>
+#include <SPI.h>
+#include "CAP1188Sim.h"
+
+// Register accesses with unknown register pointer (after SPI interface reset or beyond the last register) are counted as errors
+#define HOST_POINTER_UNKNOWN                             -1
+
+// CAP1188 on I2C bus: a write sets register pointer to the first byte and writes the rest, a read starts at register pointer.
+// Failures can be injected into the next transmissions
+class SimI2CDevice : public HostI2CDevice{
+    public:
+        SimI2CDevice(CAP1188Sim &sim, uint8_t address);
+        uint8_t write(uint8_t address, const uint8_t *data, uint8_t len, bool sendStop);
+        uint8_t read(uint8_t address, uint8_t *buff, uint8_t len, bool sendStop);
+        uint8_t failingTransmissions; // Amount of next transmissions to fail
+        uint8_t failResult;           // Wire result of failing transmissions (2 - address NACK, 3 - data NACK, 4 - other error)
+        uint8_t shortReads;           // Amount of next reads to return one byte less than requested
+        uint32_t transmissions;       // Writes and reads addressed to the device
+
+    private:
+        CAP1188Sim &_sim;
+        uint8_t _address;
+        uint8_t _pointer;
+};
+
+// SPI command decoder of CAP1188 shared by 4-wire and 3-wire models. Register pointer is kept across frames
+class SimSPIProtocol{
+    public:
+        SimSPIProtocol(CAP1188Sim &sim);
+        uint32_t frames;
+        uint32_t setPointerCommands;     // 0x7D commands
+        uint32_t interfaceResets;        // 0x7A 0x7A sequences
+        uint32_t unknownPointerAccesses; // Reads or writes, while register pointer was not known
+
+    protected:
+        void beginFrame();
+        bool receive(uint8_t data, uint8_t *readData);
+
+    private:
+        uint8_t access(bool read, uint8_t data);
+        CAP1188Sim &_sim;
+        int16_t _pointer;
+        uint8_t _operandOf; // Command waiting for its operand byte (0 if none)
+        uint8_t _resetCommands;
+};
+
+// CAP1188 on SPI 4-wire bus: data read by 0x7F is sent during the next byte. Frames sent without CS asserted are counted
+class SimSPIDevice : public HostSPIDevice, public SimSPIProtocol{
+    public:
+        SimSPIDevice(CAP1188Sim &sim, uint8_t csPin);
+        void transfer(const uint8_t *data, uint8_t *out, uint32_t len);
+        uint32_t unselectedFrames;
+        std::vector<uint8_t> lastFrame; // Bytes sent by the driver within the last frame
+
+    private:
+        uint8_t _csPin;
+};
+
+// CAP1188 on SPI 3-wire bus (bit level, SPI mode 0): CAP1188 drives SDIO during the byte following 0x7F.
+// Counts clock edges, at which both sides drive SDIO or none of them does, and direction switches of the driver
+class Sim3WireDevice : public HostPinDevice, public SimSPIProtocol{
+    public:
+        Sim3WireDevice(CAP1188Sim &sim, uint8_t csPin, uint8_t sckPin, uint8_t sdioPin);
+        void pinChanged(uint8_t pin);
+        int pinLevel(uint8_t pin);
+        uint32_t contentions;       // Driver drives SDIO, while CAP1188 does
+        uint32_t floatingBits;      // Bits sampled by CAP1188, while driver did not drive SDIO
+        uint32_t directionSwitches; // pinMode(...) calls changing direction of SDIO
+
+    private:
+        uint8_t _csPin, _sckPin, _sdioPin;
+        bool _selected;
+        uint8_t _sck;
+        uint8_t _sdioMode;
+        uint8_t _shift, _bits;
+        bool _output; // CAP1188 drives SDIO
+        uint8_t _outData;
+        int8_t _outBit;
+};
+
+// CAP1188Sim failing accesses on request (i.e. device dropped off the bus or a single glitch)
+class FailingSim : public CAP1188Sim{
+    public:
+        FailingSim();
+        bool readRegisters(uint8_t startAddress, uint8_t *buff, uint8_t len);
+        bool writeRegisters(uint8_t startAddress, const uint8_t *buff, uint8_t len);
+        bool failReads;          // Fail all reads
+        uint8_t failingAccesses; // Amount of next reads or writes to fail
+
+    private:
+        bool fail(bool read);
+};
+
+// CAP1188Sim recording every write accessing it (i.e. to check which registers a diffed update writes)
+class RecordingSim : public CAP1188Sim{
+    public:
+        struct Write
+        {
+            uint8_t startAddress;
+            uint8_t len;
+            uint8_t data;
+        };
+        bool writeRegisters(uint8_t startAddress, const uint8_t *buff, uint8_t len);
+        std::vector<Write> writes; // First byte of every write is kept
+};
+
+#endif
@@ -0,0 +1,23 @@
+/*
+ * Host tests of CAP1188 driver, which is connected to CAP1188Sim (directly or via bus level models) instead of a real device.
+ * Build and run by "make test" in this directory, non-zero exit code means a failed check.
+ */
+#include "HostTest.h"
+
+uint16_t failures = 0;
+
+int main()
+{
+    runSimTests();
+    runBusTests();
+    runDriverTests();
+    runModuleTests();
+
+    if (failures)
+    {
+        printf("%u check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All checks passed\n");
+    return 0;
+}
@@ -0,0 +1,27 @@
+#ifndef _CAP1188_HOST_TEST_H_
+#define _CAP1188_HOST_TEST_H_
+
+// Checks shared by host tests (see Makefile). A failed check is reported and counted, so all checks of a run are reported
+
+#include <stdio.h>
+#include <stdint.h>
+
+extern uint16_t failures;
+
+#define CHECK(condition)                                                    \
+    do                                                                      \
+    {                                                                       \
+        if (!(condition))                                                   \
+        {                                                                   \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            failures++;                                                     \
+        }                                                                   \
+    } while (0)
+
+// Test groups, one per test file
+void runSimTests();
+void runBusTests();
+void runDriverTests();
+void runModuleTests();
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef _CAP1188_HOST_SPI_H_
+#define _CAP1188_HOST_SPI_H_
+
+#include <Arduino.h>
+
+#define MSBFIRST                                         0x01
+#define SPI_MODE0                                        0x00
+
+class SPISettings{
+    public:
+        SPISettings(uint32_t clock, uint8_t bitOrder, uint8_t dataMode) {}
+};
+
+// Host only: model of a device on SPI bus. Every call is a single CS frame (CS is asserted by the caller),
+// data and out may point to the same buffer
+class HostSPIDevice{
+    public:
+        virtual ~HostSPIDevice() {}
+        virtual void transfer(const uint8_t *data, uint8_t *out, uint32_t len) = 0;
+};
+void hostSetSPIDevice(HostSPIDevice *device);      // NULL to disconnect
+
+// Host stand-in of SPI library. Without a HostSPIDevice MISO reads as 0xFF
+// (use CAP1188Sim via CAP1188::initTransport(...) to run the driver on a host)
+class SPIClass{
+    public:
+        void begin();
+        void beginTransaction(SPISettings settings);
+        void endTransaction();
+        void transferBytes(const uint8_t *data, uint8_t *out, uint32_t len);
+};
+
+extern SPIClass SPI;
+
+#endif
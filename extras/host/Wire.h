@@ -0,0 +1,42 @@
+#ifndef _CAP1188_HOST_WIRE_H_
+#define _CAP1188_HOST_WIRE_H_
+
+#include <Arduino.h>
+
+#define HOST_WIRE_BUFFER_LENGTH                          32
+
+// Host only: model of a device on I2C bus. Results follow Wire library (0 - success, 2 - address NACK, 3 - data NACK, 4 - other error)
+class HostI2CDevice{
+    public:
+        virtual ~HostI2CDevice() {}
+        virtual uint8_t write(uint8_t address, const uint8_t *data, uint8_t len, bool sendStop) = 0;
+        virtual uint8_t read(uint8_t address, uint8_t *buff, uint8_t len, bool sendStop) = 0; // Returns amount of bytes read
+};
+void hostSetI2CDevice(HostI2CDevice *device);      // NULL to disconnect
+
+// Host stand-in of Wire library. Without a HostI2CDevice every transmission is NACKed
+// (use CAP1188Sim via CAP1188::initTransport(...) to run the driver on a host)
+class TwoWire{
+    public:
+        TwoWire();
+        void begin();
+        void setClock(uint32_t clock);
+        void beginTransmission(uint8_t address);
+        uint8_t endTransmission(bool sendStop = true);
+        uint8_t requestFrom(uint8_t address, uint8_t len, uint8_t sendStop = 1);
+        size_t write(uint8_t data);
+        size_t write(const uint8_t *buff, size_t len);
+        int available();
+        int read();
+
+    private:
+        uint8_t _address;
+        uint8_t _txBuffer[HOST_WIRE_BUFFER_LENGTH];
+        uint8_t _txLen;
+        uint8_t _rxBuffer[HOST_WIRE_BUFFER_LENGTH];
+        uint8_t _rxLen, _rxIndex;
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -1,135 +1,399 @@
-#include <I2Cdev.h> // TODO: Move to Wire.h
-#include <SPI.h>
 #include "CAP1188.h"
+#if !defined(CAP1188_DISABLE_I2C)
+#include <Wire.h>
+#endif
+#if !defined(CAP1188_DISABLE_SPI)
+#include <SPI.h>
+#endif
 #include "CAP1188_reg.h"
 
+#if defined(CAP1188_ENABLE_STATS)
+#define CAP1188_STATS(statement) statement
+#else
+#define CAP1188_STATS(statement)
+#endif
+
+// Register ranges kept in shadow register file. Registers, which are changed by CAP1188 itself
+// (status, counts, calibration activate) are not shadowed
+static constexpr struct
+{
+    uint8_t start;
+    uint8_t len;
+} shadowRanges[] = {
+    {CAP1188_MAIN_CONTROL_REG, 1},
+    {CAP1188_SENSITIVITY_CONTROL_REG, 6},                     // 0x1F-0x24
+    {CAP1188_INTERRUPT_ENABLE_REG, 2},                        // 0x27-0x28
+    {CAP1188_MULTIPLE_TOUCH_CONFIGURATION_REG, 2},            // 0x2A-0x2B
+    {CAP1188_MULTIPLE_TOUCH_PATTERN_REG, 1},
+    {CAPP1188_RECALIBRATION_CONFIGURATION_REG, 10},           // 0x2F-0x38
+    {CAP1188_STANDBY_CHANNEL_REG, 5},                         // 0x40-0x44
+    {CAP1188_LED_OUTPUT_TYPE_REG, 4},                         // 0x71-0x74
+    {CAP1188_LINKED_LED_TRANSITION_CONTROL_REG, 1},
+    {CAP1188_LED_MIRROR_CONTROL_REG, 1},
+    {CAP1188_LED_BEHAVIOR_1_REG, 2},                          // 0x81-0x82
+    {CAP1188_LED_PULSE_1_PERIOD_REG, 3},                      // 0x84-0x86
+    {CAP1188_LED_CONFIG_REG, 1},
+    {CAP1188_LED_PULSE_1_DUTY_CYCLE_REG, 6},                  // 0x90-0x95
+};
+
+/**
+ * @brief Sums lengths of shadowed register ranges (compile-time check of CAP1188_SHADOW_SIZE)
+ * @param index first range to sum up from
+ * @return amount of shadowed registers in ranges starting at index
+ */
+static constexpr uint16_t shadowRangesSize(uint8_t index = 0)
+{
+    return index < sizeof(shadowRanges) / sizeof(shadowRanges[0]) ? shadowRanges[index].len + shadowRangesSize(index + 1) : 0;
+}
+
+static_assert(shadowRangesSize() == CAP1188_SHADOW_SIZE, "CAP1188_SHADOW_SIZE has to match total length of shadowRanges");
+
+// Holds bus lock of a device (if any) while in scope, so composed operations are not interleaved with other bus users
+class CAP1188BusGuard
+{
+    public:
+        CAP1188BusGuard(CAP1188 &device) : _device(device)
+        {
+            _device.lockBus();
+        }
+        ~CAP1188BusGuard()
+        {
+            _device.unlockBus();
+        }
+
+    private:
+        CAP1188 &_device;
+};
+
+/**
+ * @brief Instantiates a new CAP1188 class. Initialise it using *.initI2C(...), *.initSPI(...) or *.initTransport(...)
+ */
+CAP1188::CAP1188() : _interface(CAP1188_INTERFACE_NONE), _lastStatus(CAP1188_STATUS_OK), _retries(CAP1188_DEFAULT_RETRIES),
+                     _retryBackoffUs(CAP1188_DEFAULT_RETRY_BACKOFF_US), _resetPin(CAP1188_NO_RESET_PIN), _spi3Wire(false), _sdioOutput(false), _transport(NULL), _spiClock(CAP1188_SPI_DEFAULT_CLOCK), _regPointer(CAP1188_REG_POINTER_UNKNOWN),
+                     _initState(CAP1188_INIT_STATE_NONE), _warmStart(false), _resetStart(0),
+                     _alertPin(-1), _alertPending(false), _alertTimestamp(0), _lastInputs(0),
+                     _leds(0), _ledsDirty(false), _lock(NULL), _unlock(NULL), _lockArg(NULL)
+{
+#if defined(ESP32)
+    _task = NULL;
+    _queue = NULL;
+    _busMutex = NULL;
+    _ownBusMutex = false;
+    _taskStopping = false;
+#endif
+#if !defined(CAP1188_DISABLE_I2C)
+    _wire = &Wire;
+#endif
+#if !defined(CAP1188_DISABLE_SPI)
+    _spi = &SPI;
+#endif
+    invalidateShadow();
+    CAP1188_STATS(resetStats());
+};
+
 /**
- * @brief Instantiates a new CAP1188 class. Initialise it using *.initI2C(...) or *.initSPI(...)
+ * @brief Stops the task started by startTask(...) (ESP32) and disables interrupt driven mode, so neither refers to a destroyed object
  */
-CAP1188::CAP1188(){};
+CAP1188::~CAP1188()
+{
+#if defined(ESP32)
+    stopTask();
+#endif
+    detachAlert();
+}
 
+#if !defined(CAP1188_DISABLE_I2C)
 /**
- * @brief Initilises CAP1188 module using I2C interface.
+ * @brief Initilises CAP1188 module using I2C interface (default Wire bus). NOTE: Wire.begin() must be called beforehand
  * Following actions are done during initlisation:
  * 1. CAP1188 is reset by holding RESET pin HIGH
  * 2. CAP1188 is set to allow multiple touches at the same time
  * 3. CAP1188 buttons and LEDs are linked (corresponding LED turns on when corresponding button is pressed)
  * @param address I2C address of a device (possible options: 0x28, 0x29(defualt), 0x2A, 0x2B, 0x2C)
- * @param resetPin Chip RESET pin number
+ * @param resetPin Chip RESET pin number (CAP1188_NO_RESET_PIN if not connected)
+ * @param initMode CAP1188_INIT_COLD or combination of CAP1188_INIT_WARM, CAP1188_INIT_NO_WAIT (see initDevice(...))
  * @returns void
  */
-void CAP1188::initI2C(uint8_t address, uint8_t resetPin)
+void CAP1188::initI2C(uint8_t address, uint8_t resetPin, uint8_t initMode)
 {
+    initI2C(Wire, address, resetPin, initMode);
+}
+
+/**
+ * @brief Initilises CAP1188 module using I2C interface on a given bus (i.e. Wire1), so devices can be spread across
+ * independent buses. NOTE: begin() of a bus must be called beforehand. Same actions as in case of initI2C(address, ...) are done
+ * @param wire I2C bus CAP1188 is connected to (has to outlive CAP1188 object)
+ * @param address I2C address of a device (possible options: 0x28, 0x29(defualt), 0x2A, 0x2B, 0x2C)
+ * @param resetPin Chip RESET pin number (CAP1188_NO_RESET_PIN if not connected)
+ * @param initMode CAP1188_INIT_COLD or combination of CAP1188_INIT_WARM, CAP1188_INIT_NO_WAIT (see initDevice(...))
+ * @returns void
+ */
+void CAP1188::initI2C(TwoWire &wire, uint8_t address, uint8_t resetPin, uint8_t initMode)
+{
+    _wire = &wire;
     _resetPin = resetPin;
     _i2cAddress = address;
-    _i2c = true;
-
-    pinMode(_resetPin, OUTPUT);
+    _interface = CAP1188_INTERFACE_I2C;
 
-    // Reset CAP1188 module
-    digitalWrite(_resetPin, HIGH);
-    delay(10);
-    digitalWrite(_resetPin, LOW);
-
-    // Allow multiple touches
-    setMultipleTouchConfiguration(0, 0);
-
-    // Link LEDs and buttons
-    setSensorInputLEDLinking(0b11111111);
+    initDevice(initMode);
 }
+#endif
 
+#if !defined(CAP1188_DISABLE_SPI)
 /**
- * @brief Initilises CAP1188 module using SPI 4-wire (aka Normal mode) interface.
+ * @brief Initilises CAP1188 module using SPI 4-wire (aka Normal mode) interface (default SPI bus). NOTE: SPI.begin() must be called beforehand
  * Following actions are done during initlisation:
  * 1. CAP1188 is reset by holding RESET pin HIGH
  * 2. CAP1188 is set to allow multiple touches at the same time
  * 3. CAP1188 buttons and LEDs are linked (corresponding LED turns on when corresponding button is pressed)
  * @param csPin CS pin of a device (must be any arbitrary GPIO pin)
- * @param resetPin Chip RESET pin number
+ * @param resetPin Chip RESET pin number (CAP1188_NO_RESET_PIN if not connected)
+ * @param initMode CAP1188_INIT_COLD or combination of CAP1188_INIT_WARM, CAP1188_INIT_NO_WAIT (see initDevice(...))
+ * @returns void
+ */
+void CAP1188::initSPI(uint8_t csPin, uint8_t resetPin, uint8_t initMode)
+{
+    initSPI(SPI, csPin, resetPin, initMode);
+}
+
+/**
+ * @brief Initilises CAP1188 module using SPI 4-wire (aka Normal mode) interface on a given bus (i.e. HSPI/VSPI on ESP32),
+ * so devices can be spread across independent buses. NOTE: begin() of a bus must be called beforehand.
+ * Same actions as in case of initSPI(csPin, ...) are done
+ * @param spi SPI bus CAP1188 is connected to (has to outlive CAP1188 object)
+ * @param csPin CS pin of a device (must be any arbitrary GPIO pin)
+ * @param resetPin Chip RESET pin number (CAP1188_NO_RESET_PIN if not connected)
+ * @param initMode CAP1188_INIT_COLD or combination of CAP1188_INIT_WARM, CAP1188_INIT_NO_WAIT (see initDevice(...))
+ * @returns void
+ */
+void CAP1188::initSPI(SPIClass &spi, uint8_t csPin, uint8_t resetPin, uint8_t initMode)
+{
+    _spi = &spi;
+    _resetPin = resetPin;
+    _csPin = csPin;
+    _spi3Wire = false;
+    _interface = CAP1188_INTERFACE_SPI;
+
+    pinMode(_csPin, OUTPUT);
+
+    initDevice(initMode);
+}
+
+/**
+ * @brief Initilises CAP1188 module using SPI 3-wire (aka BiDirectional mode) interface, SDI and SDO of CAP1188 share a single pin.
+ * Bus is driven in software (SPI library is not used), data line only turns into an output while commands are sent,
+ * so it can be shared with other (half-duplex) peripherals. Same actions as in case of initSPI(...) are done during initialisation
+ * @param csPin CS pin of a device (must be any arbitrary GPIO pin)
+ * @param sckPin GPIO connected to SPI_CLK pin of CAP1188
+ * @param sdioPin GPIO connected to SPI_MOSI (SDIO) pin of CAP1188
+ * @param resetPin Chip RESET pin number (CAP1188_NO_RESET_PIN if not connected)
+ * @param initMode CAP1188_INIT_COLD or combination of CAP1188_INIT_WARM, CAP1188_INIT_NO_WAIT (see initDevice(...))
  * @returns void
  */
-void CAP1188::initSPI(uint8_t csPin, uint8_t resetPin)
+void CAP1188::initSPI3Wire(uint8_t csPin, uint8_t sckPin, uint8_t sdioPin, uint8_t resetPin, uint8_t initMode)
 {
     _resetPin = resetPin;
     _csPin = csPin;
-    _i2c = false;
+    _sckPin = sckPin;
+    _sdioPin = sdioPin;
+    _spi3Wire = true;
+    _interface = CAP1188_INTERFACE_SPI;
 
-    pinMode(_resetPin, OUTPUT);
+    digitalWrite(_csPin, HIGH);
     pinMode(_csPin, OUTPUT);
+    digitalWrite(_sckPin, LOW); // SPI mode 0: clock idles low
+    pinMode(_sckPin, OUTPUT);
+    pinMode(_sdioPin, INPUT);
+    _sdioOutput = false;
+
+    initDevice(initMode);
+}
+#endif
+
+/**
+ * @brief Initilises CAP1188 module using a user supplied transport (i.e. CAP1188Sim to run off-target, or another bus driver).
+ * Same actions as in case of initI2C(...) or initSPI(...) are done during initialisation
+ * @param transport transport to access CAP1188 registers with (has to outlive CAP1188 object)
+ * @param resetPin Chip RESET pin number (CAP1188_NO_RESET_PIN if not connected)
+ * @param initMode CAP1188_INIT_COLD or combination of CAP1188_INIT_WARM, CAP1188_INIT_NO_WAIT (see initDevice(...))
+ * @returns void
+ */
+void CAP1188::initTransport(CAP1188Transport &transport, uint8_t resetPin, uint8_t initMode)
+{
+    _resetPin = resetPin;
+    _transport = &transport;
+    _interface = CAP1188_INTERFACE_CUSTOM;
+
+    initDevice(initMode);
+}
 
-    // Reset CAP1188 module
-    digitalWrite(_resetPin, HIGH);
-    delay(10);
-    digitalWrite(_resetPin, LOW);
-    resetSPI(); // Reset SPI interface of CAP1188 module
+/**
+ * @brief Checks if initialisation is finished. Has to be polled after init...(...) with CAP1188_INIT_NO_WAIT,
+ * reset is finished and driver configuration is applied by the call that finds reset pulse to be over.
+ * Other functions must not be used until it returns true
+ * @returns true if CAP1188 is initialised, false if reset is still in progress or CAP1188 is not initialised at all
+ */
+bool CAP1188::isReady()
+{
+    if (_initState == CAP1188_INIT_STATE_RESET)
+    {
+        if (millis() - _resetStart < CAP1188_RESET_PULSE_MS)
+        {
+            return false;
+        }
+        digitalWrite(_resetPin, LOW);
+        startDevice();
+    }
+    return _initState == CAP1188_INIT_STATE_READY;
+}
+
+/**
+ * @brief Tells if the last initialisation found CAP1188 already configured, so reset and configuration were skipped
+ * (CAP1188_INIT_WARM). Register contents set by the user before (i.e. thresholds) are retained in that case
+ * @returns true if CAP1188 was warm started, false otherwise
+ */
+bool CAP1188::isWarmStart()
+{
+    return _warmStart;
+}
+
+/**
+ * @brief Resets CAP1188 module and applies default configuration of the driver (shared by all init...(...) functions).
+ * With CAP1188_INIT_WARM reset and configuration are skipped if CAP1188 already runs with configuration of the driver
+ * (i.e. MCU woke up from deep sleep, while CAP1188 stayed powered). With CAP1188_INIT_NO_WAIT RESET pin is left HIGH
+ * and function returns immediately, isReady() finishes initialisation later
+ * @param initMode CAP1188_INIT_COLD or combination of CAP1188_INIT_WARM, CAP1188_INIT_NO_WAIT
+ * @returns void
+ */
+void CAP1188_COLD_ATTR CAP1188::initDevice(uint8_t initMode)
+{
+    _initState = CAP1188_INIT_STATE_NONE;
+    _warmStart = false;
+    invalidateShadow(); // Nothing is known about register contents yet
+#if !defined(CAP1188_DISABLE_SPI)
+    if (_interface == CAP1188_INTERFACE_SPI)
+    {
+        resetSPI(); // Reset SPI interface of CAP1188 module (register pointer is no longer known after that)
+    }
+#endif
+
+    if ((initMode & CAP1188_INIT_WARM) && isConfigured())
+    {
+        _warmStart = true;
+        _initState = CAP1188_INIT_STATE_READY;
+        return;
+    }
+
+    if (_resetPin != CAP1188_NO_RESET_PIN)
+    {
+        pinMode(_resetPin, OUTPUT);
+
+        // Reset CAP1188 module
+        digitalWrite(_resetPin, HIGH);
+        if (initMode & CAP1188_INIT_NO_WAIT)
+        {
+            _resetStart = millis();
+            _initState = CAP1188_INIT_STATE_RESET;
+            return;
+        }
+        delay(CAP1188_RESET_PULSE_MS);
+        digitalWrite(_resetPin, LOW);
+    }
+    startDevice();
+}
+
+/**
+ * @brief Applies default configuration of the driver to CAP1188 coming out of reset
+ * @returns void
+ */
+void CAP1188_COLD_ATTR CAP1188::startDevice()
+{
+    invalidateShadow(); // All registers are back to their defaults
+#if !defined(CAP1188_DISABLE_SPI)
+    if (_interface == CAP1188_INTERFACE_SPI)
+    {
+        resetSPI();
+    }
+#endif
 
-    // Allow multiple touches
-    setMultipleTouchConfiguration(0, 0);
+    // Disable multiple touch circuitry (any amount of simultaneous touches is reported)
+    writeRegister(CAP1188_MULTIPLE_TOUCH_CONFIGURATION_REG, CAP1188_INIT_MULTIPLE_TOUCH_CONFIG);
 
     // Link LEDs and buttons
-    setSensorInputLEDLinking(0b11111111);
+    writeRegister(CAP1188_SENSOR_INPUT_LED_LINKING_REG, CAP1188_INIT_LED_LINKING);
+
+    // LED outputs are off after reset
+    _leds = 0;
+    _ledsDirty = false;
+
+    _initState = CAP1188_INIT_STATE_READY;
+}
+
+/**
+ * @brief Checks if CAP1188 is present and already runs with default configuration of the driver.
+ * IDs are read within a single burst, then configuration fingerprint (registers written by startDevice()) is compared
+ * @returns true if CAP1188 is configured, false otherwise
+ */
+bool CAP1188_COLD_ATTR CAP1188::isConfigured()
+{
+    uint8_t ids[3]; // Product ID, manufacturer ID, revision
+    if (!readRegisters(CAP1188_PRODUCT_ID_REG, ids, sizeof(ids)) || ids[0] != CAP1188_PRODUCT_ID || ids[1] != CAP1188_MANUFACTURER_ID)
+    {
+        return false;
+    }
+
+    uint8_t multipleTouchConfig, ledLinking;
+    if (!readRegister(CAP1188_MULTIPLE_TOUCH_CONFIGURATION_REG, &multipleTouchConfig) ||
+        !readRegister(CAP1188_SENSOR_INPUT_LED_LINKING_REG, &ledLinking))
+    {
+        return false;
+    }
+    return multipleTouchConfig == CAP1188_INIT_MULTIPLE_TOUCH_CONFIG && ledLinking == CAP1188_INIT_LED_LINKING;
 }
 
 /**
  * @brief Reads & returns product ID of a module
- * @returns product ID of a module
+ * @returns product ID of a module, 0 on error
  */
 uint8_t CAP1188::getProductId()
 {
     uint8_t productId;
-    if (!_i2c)
+    if (!readRegister(CAP1188_PRODUCT_ID_REG, &productId))
     {
-        // SPI
-        readRegisterFromAddress(CAP1188_PRODUCT_ID_REG, &productId);
-    }
-    else
-    {
-        // I2C
-        I2Cdev::readByte(_i2cAddress, CAP1188_PRODUCT_ID_REG, &productId);
+        return 0;
     }
     return productId;
 }
 
 /**
  * @brief Reads & returns manufacturer ID of a module
- * @returns manufacturer ID of a module
+ * @returns manufacturer ID of a module, 0 on error
  */
 uint8_t CAP1188::getManufacturerId()
 {
     uint8_t manufacturerId;
-    if (!_i2c)
-    {
-        // SPI
-        readRegisterFromAddress(CAP1188_MANUFACTURER_ID_REG, &manufacturerId);
-    }
-    else
+    if (!readRegister(CAP1188_MANUFACTURER_ID_REG, &manufacturerId))
     {
-        // I2C
-        I2Cdev::readByte(_i2cAddress, CAP1188_MANUFACTURER_ID_REG, &manufacturerId);
+        return 0;
     }
     return manufacturerId;
 }
 
 /**
  * @brief Reads & returns revision of a module
- * @returns revision of a module
+ * @returns revision of a module, 0 on error
  */
 uint8_t CAP1188::getRevision()
 {
     uint8_t revision;
-    if (!_i2c)
-    {
-        // SPI
-        readRegisterFromAddress(CAP1188_REVISION_REG, &revision);
-    }
-    else
+    if (!readRegister(CAP1188_REVISION_REG, &revision))
     {
-        // I2C
-        I2Cdev::readByte(_i2cAddress, CAP1188_REVISION_REG, &revision);
+        return 0;
     }
     return revision;
 }
 
+#if CAP1188_HAS_FEATURE(CAP1188_FEATURE_THRESHOLDS)
 /**
  * @brief Writes data to Multiple Touch Configuration Register, that controls settings for the multiple touch detection circuitry.
  * @param multipleTouchCircuitryEnable multiple touch circuitry enable setting (true to turn it on, false to turn it off)
@@ -169,116 +433,119 @@ bool CAP1188::setMultipleTouchConfiguration(bool multipleTouchCircuitryEnable, u
         }
     }
 
-    if (!_i2c)
-    {
-        // SPI
-        writeRegisterAtAddress(CAP1188_MULTIPLE_TOUCH_CONFIGURATION_REG, buff);
-    }
-    else
-    {
-        // I2C
-        I2Cdev::writeByte(_i2cAddress, CAP1188_MULTIPLE_TOUCH_CONFIGURATION_REG, buff);
-    }
-    return true;
+    return writeRegister(CAP1188_MULTIPLE_TOUCH_CONFIGURATION_REG, buff);
 }
+#endif
+
+#if CAP1188_HAS_FEATURE(CAP1188_FEATURE_LED)
 /**
  * @brief Writes data to Sensor Input LED Linking Register, which controls whether a capacitive touch sensor input is linked to an LED output.
  * @param ledsToLink 8-bit data that links LEDs to buttons (i.e. 0b00001111 will turn LED linking on between L1-L4 and C1-C4)
- * @return true
+ * @return true on success, false on error
  */
 bool CAP1188::setSensorInputLEDLinking(uint8_t ledsToLink)
 {
-    if (!_i2c)
-    {
-        // SPI
-        writeRegisterAtAddress(CAP1188_SENSOR_INPUT_LED_LINKING_REG, ledsToLink);
-    }
-    else
-    {
-        // I2C
-        I2Cdev::writeByte(_i2cAddress, CAP1188_SENSOR_INPUT_LED_LINKING_REG, ledsToLink);
-    }
-    return true;
+    return writeRegister(CAP1188_SENSOR_INPUT_LED_LINKING_REG, ledsToLink);
+}
+#endif
+
+#if CAP1188_HAS_FEATURE(CAP1188_FEATURE_THRESHOLDS)
+/**
+ * @brief Configures multiple touch pattern (MTP) detection of CAP1188 (MULTIPLE TOUCH PATTERN CONFIGURATION and
+ * MULTIPLE TOUCH PATTERN registers). Detected pattern sets MTP bit in GENERAL STATUS REGISTER and optionally asserts ALERT.
+ * NOTE: To only get ALERT on a pattern (and not on every touch), disable interrupts of inputs by setInterruptEnable(0)
+ * @param enable true to enable pattern detection, false to disable it
+ * @param pattern inputs of a pattern in binary format (CAP1188_MTP_MODE_PATTERN) or as many bits set as inputs have to be touched (CAP1188_MTP_MODE_COUNT)
+ * @param mode use CAP1188_MTP_MODE_...
+ * @param threshold use CAP1188_MTP_THRESHOLD_...
+ * @param alert true to assert ALERT when pattern is detected
+ * @return true on success, false on error
+ */
+bool CAP1188::setMultipleTouchPattern(bool enable, uint8_t pattern, uint8_t mode, uint8_t threshold, bool alert)
+{
+    uint8_t config = (enable ? 0x80 : 0x00) | (threshold & 0x03) << 2 | (mode & 0x01) << 1 | (alert ? 0x01 : 0x00);
+    // Pattern is written first, so detection is never enabled with a stale pattern
+    return writeChangedRegisters(CAP1188_MULTIPLE_TOUCH_PATTERN_REG, &pattern, 1) &&
+           writeChangedRegisters(CAP1188_MULTIPLE_TOUCH_PATTERN_CONFIGUATION_REG, &config, 1);
+}
+
+/**
+ * @brief Checks MTP bit of GENERAL STATUS REGISTER. NOTE: Bit stays set until INT is cleared (i.e. by getSensorInputs())
+ * @return true if multiple touch pattern was detected, false otherwise or on error
+ */
+bool CAP1188::isMultipleTouchPatternDetected()
+{
+    uint8_t generalStatus;
+    return readRegister(CAP1188_GENERAL_STATUS_REG, &generalStatus) && (generalStatus & CAP1188_GENERAL_STATUS_MTP_BIT);
+}
+#endif
+
+/**
+ * @brief Selects inputs, touches (and releases) of which assert ALERT (INTERRUPT ENABLE REGISTER, all inputs are enabled by default)
+ * @param inputs inputs in binary format
+ * @return true on success, false on error
+ */
+bool CAP1188::setInterruptEnable(uint8_t inputs)
+{
+    return writeRegister(CAP1188_INTERRUPT_ENABLE_REG, inputs);
 }
 
 /**
  * @brief Reads keys pressed from a module. I.e.
  * if key 1 & 3 pressed, returns b00000101 (5 in decimal)
- * @return keys pressed in binary format
+ * @return keys pressed in binary format, 0 on error (see getLastStatus())
  */
-uint8_t CAP1188::getSensorInputs()
+uint8_t CAP1188_HOT_ATTR CAP1188::getSensorInputs()
 {
     uint8_t keys;
-    // Reading keys
-    if (!_i2c)
-    {
-        // SPI
-        readRegisterFromAddress(CAP1188_SENSOR_INPUT_STATUS_REG, &keys);
-    }
-    else
+    readSensorInputs(&keys);
+    return keys;
+}
+
+/**
+ * @brief Reads SENSOR INPUT STATUS REGISTER and clears INT if any input is touched (see getSensorInputs())
+ * @param keys buffer to receive keys pressed in binary format in to (0 on error)
+ * @return true if status register was read, false on error (result of INT clear is only reflected by getLastStatus())
+ */
+bool CAP1188_HOT_ATTR CAP1188::readSensorInputs(uint8_t *keys)
+{
+    CAP1188BusGuard guard(*this); // Read and INT clear are not interleaved with other bus users
+    if (!readRegister(CAP1188_SENSOR_INPUT_STATUS_REG, keys))
     {
-        // I2C
-        I2Cdev::readByte(_i2cAddress, CAP1188_SENSOR_INPUT_STATUS_REG, &keys);
+        *keys = 0;
+        return false;
     }
-    if (keys)
+    if (*keys)
     {
-        // Bring INT down
-        // 1. Read current register state
-        // 2. Modify INT bit (located at BIT0)
-        // 3. Write register back
-        uint8_t currentRegState;
-        if (!_i2c)
-        {
-            // SPI
-            readRegisterFromAddress(CAP1188_MAIN_CONTROL_REG, &currentRegState);
-        }
-        else
-        {
-            // I2C
-            I2Cdev::readByte(_i2cAddress, CAP1188_MAIN_CONTROL_REG, &currentRegState);
-        }
-
-        currentRegState = currentRegState & ~0x01;
-
-        if (!_i2c)
-        {
-            // SPI
-            writeRegisterAtAddress(CAP1188_MAIN_CONTROL_REG, currentRegState);
-        }
-        else
-        {
-            // I2C
-            I2Cdev::writeByte(_i2cAddress, CAP1188_MAIN_CONTROL_REG, currentRegState);
-        }
+        clearInterrupt();
     }
+    return true;
+}
 
-    return keys;
+/**
+ * @brief Brings INT bit (BIT0 of MAIN CONTROL REGISTER) down, so CAP1188 releases ALERT and latched sensor inputs.
+ * Current register state is taken from shadow register file, so only a write is sent
+ * @return true on success, false on error
+ */
+bool CAP1188_HOT_ATTR CAP1188::clearInterrupt()
+{
+    return modifyRegister(CAP1188_MAIN_CONTROL_REG, CAP1188_MAIN_CONTROL_INT_BIT, 0x00);
 }
 
+#if CAP1188_HAS_FEATURE(CAP1188_FEATURE_STANDBY)
 /**
  * @brief Writes data to Standby Configuration Register, that controls averaging and cycle time while in standby.
  * @param averageSum Determines whether the active sensor inputs will average the programmed number of samples or whether they will accumulate for the programmed number of samples (use CAP1188_AVG_SUM_...)
  * @param samplesPerMeasurement Determines the number of samples that are taken for all active channels during the sensor cycle (use CAP1188_SAMPLES_PER_MEASUREMENT_...)
  * @param samplingTime Determines the time to take a single sample when the device is in Standby (use CAP1188_SAMPLING_TIME_...)
  * @param cycleTime Determines the overall cycle time for all measured channels during standby operation (use CAP1188_CYCLE_TIME_...)
- * @return true
+ * @return true on success, false on error
  */
 bool CAP1188::setStandbyConfiguration(uint8_t averageSum, uint8_t samplesPerMeasurement, uint8_t samplingTime, uint8_t cycleTime)
 {
     uint8_t reg;
-    reg = averageSum << 7 | samplesPerMeasurement << 4 | samplingTime << 2 | cycleTime;
-    if (!_i2c)
-    {
-        // SPI
-        writeRegisterAtAddress(CAP1188_STANDBY_CONFIGURATION_REG, reg);
-    }
-    else
-    {
-        // I2C
-        I2Cdev::writeByte(_i2cAddress, CAP1188_STANDBY_CONFIGURATION_REG, reg);
-    }
-
-    return true;
+    reg = CAP1188_STANDBY_CONFIG(averageSum, samplesPerMeasurement, samplingTime, cycleTime);
+    return writeRegister(CAP1188_STANDBY_CONFIGURATION_REG, reg);
 }
 
 /**
@@ -287,20 +554,14 @@ bool CAP1188::setStandbyConfiguration(uint8_t averageSum, uint8_t samplesPerMeas
  * @param samplesPerMeasurement buffer to receive "amount of samples per measurement" in to
  * @param samplingTime buffer to receive "sampling time" in to
  * @param cycleTime buffer to receive "cycle time" in to
- * @return true
+ * @return true on success, false on error
  */
 bool CAP1188::getStandbyConfiguration(uint8_t *averageSum, uint8_t *samplesPerMeasurement, uint8_t *samplingTime, uint8_t *cycleTime)
 {
     uint8_t reg;
-    if (!_i2c)
-    {
-        // SPI
-        readRegisterFromAddress(CAP1188_STANDBY_CONFIGURATION_REG, &reg);
-    }
-    else
+    if (!readRegister(CAP1188_STANDBY_CONFIGURATION_REG, &reg))
     {
-        // I2C
-        I2Cdev::readByte(_i2cAddress, CAP1188_STANDBY_CONFIGURATION_REG, &reg);
+        return false;
     }
 
     *averageSum = reg >> 7;
@@ -312,471 +573,2180 @@ bool CAP1188::getStandbyConfiguration(uint8_t *averageSum, uint8_t *samplesPerMe
 }
 
 /**
- * @brief Writes data to Averaging and Sampling Configuration register that controls the number of samples taken and
- * the total sensor input cycle time for all active sensor inputs while the device is functioning in Active state.
- * @param samplesPerMeasurement Determines the number of samples that are taken for all active channels during the sensor cycle (use CAP1188_SAMPLES_PER_MEASUREMENT_...)
- * @param samplingTime  Determines the time to take a single sample (use CAP1188_SAMPLING_TIME_...)
- * @param cycleTime Determines the number of samples that are taken for all active channels during the sensor cycle (use CAP1188_CYCLE_TIME_...)
- * @return true
+ * @brief Selects sensor inputs, which are sensed while in standby (STANDBY CHANNEL REGISTER). Touches of these inputs still
+ * assert ALERT (if enabled by setInterruptEnable(...)), other inputs are not sensed at all
+ * @param inputs inputs in binary format (i.e. 0b00000001 to only wake up by input 1)
+ * @return true on success, false on error
  */
-bool CAP1188::setAveragingAndSamplingConfig(uint8_t samplesPerMeasurement, uint8_t samplingTime, uint8_t cycleTime)
+bool CAP1188::setStandbyChannels(uint8_t inputs)
+{
+    return writeRegister(CAP1188_STANDBY_CHANNEL_REG, inputs);
+}
+
+/**
+ * @brief Reads sensor inputs, which are sensed while in standby
+ * @return inputs in binary format, 0 if none or on error
+ */
+uint8_t CAP1188::getStandbyChannels()
 {
     uint8_t reg;
-    reg = samplesPerMeasurement << 4 | samplingTime << 2 | cycleTime;
-    if (!_i2c)
-    {
-        // SPI
-        writeRegisterAtAddress(CAP1188_AVERAGING_AND_SAMPLING_CONFIG_REG, reg);
-    }
-    else
+    if (!getShadow(CAP1188_STANDBY_CHANNEL_REG, &reg) && !readRegister(CAP1188_STANDBY_CHANNEL_REG, &reg))
     {
-        // I2C
-        I2Cdev::writeByte(_i2cAddress, CAP1188_AVERAGING_AND_SAMPLING_CONFIG_REG, reg);
+        return 0;
     }
+    return reg;
+}
 
-    return true;
+/**
+ * @brief Sets sensitivity of standby channels (STANDBY SENSITIVITY REGISTER). Higher sensitivity allows to wake up
+ * with fewer and shorter samples (see setStandbyConfiguration(...))
+ * @param sensitivity use CAP1188_SENSITIVITY_... (CAP1188_SENSITIVITY_32X by default)
+ * @return true on success, false on error
+ */
+bool CAP1188::setStandbySensitivity(uint8_t sensitivity)
+{
+    return writeRegister(CAP1188_STANDBY_SENSITIVITY_REG, sensitivity & 0x07);
 }
 
 /**
- * @brief Reads data from Averaging and Sampling Configuration register that controls the number of samples taken and
- * the total sensor input cycle time for all active sensor inputs while the device is functioning in Active state.
- * @param samplesPerMeasurement buffer to receive "amount of samples per measurement" in to
- * @param samplingTime buffer to receive "sampling time" in to
- * @param cycleTime buffer to receive "cycle time" in to
- * @return true
+ * @brief Reads sensitivity of standby channels
+ * @return CAP1188_SENSITIVITY_..., 0 on error (see getLastStatus())
  */
-bool CAP1188::getAveragingAndSamplingConfig(uint8_t *samplesPerMeasurement, uint8_t *samplingTime, uint8_t *cycleTime)
+uint8_t CAP1188::getStandbySensitivity()
 {
     uint8_t reg;
-    if (!_i2c)
+    if (!getShadow(CAP1188_STANDBY_SENSITIVITY_REG, &reg) && !readRegister(CAP1188_STANDBY_SENSITIVITY_REG, &reg))
     {
-        // SPI
-        readRegisterFromAddress(CAP1188_AVERAGING_AND_SAMPLING_CONFIG_REG, &reg);
+        return 0;
     }
-    else
+    return reg & 0x07;
+}
+
+/**
+ * @brief Sets delta count threshold of all standby channels (STANDBY THRESHOLD REGISTER), same units as
+ * setSensorInputThreshold(...) use
+ * @param threshold threshold number (USE CAP1188_SENSOR_INPUT_THRESHOLD_...)
+ * @return true on success, false on error
+ */
+bool CAP1188::setStandbyThreshold(uint8_t threshold)
+{
+    return writeRegister(CAP1188_STANDBY_THRESHOLD_REG, threshold & 0x7F);
+}
+
+/**
+ * @brief Reads delta count threshold of standby channels
+ * @return threshold, 0 on error
+ */
+uint8_t CAP1188::getStandbyThreshold()
+{
+    uint8_t reg;
+    if (!getShadow(CAP1188_STANDBY_THRESHOLD_REG, &reg) && !readRegister(CAP1188_STANDBY_THRESHOLD_REG, &reg))
     {
-        // I2C
-        I2Cdev::readByte(_i2cAddress, CAP1188_AVERAGING_AND_SAMPLING_CONFIG_REG, &reg);
+        return 0;
     }
-    *samplesPerMeasurement = (reg >> 4) & 0x07;
-    *samplingTime = (reg >> 2) & 0x03;
-    *cycleTime = reg & 0x03;
-    return true;
+    return reg & 0x7F;
 }
+
 /**
- * @brief Writes data to a specific Sensor Input Threshold register, which store the delta threshold that is used to determine if a touch has been detected
- * @param buttonNumber number of a button netween 1...8
- * @param threshold threshold number (USE CAP1188_SENSOR_INPUT_THRESHOLD_...)
+ * @brief Switches CAP1188 between active, standby and deep sleep (STBY and DSLEEP bits of MAIN CONTROL REGISTER).
+ * In standby only standby channels are sensed and their touches assert ALERT, so in interrupt driven mode
+ * (see attachAlert(...)) both MCU and CAP1188 can idle until a touch, i.e. MCU sleeps with ALERT pin as wake-up source.
+ * Register is read from CAP1188 rather than taken from shadow register file, so INT bit is written back as is
+ * and a touch, which is not serviced yet, keeps ALERT asserted
+ * @param state use CAP1188_POWER_...
  * @return true on success, false on error
  */
-bool CAP1188::setSensorInputThreshold(uint8_t buttonNumber, uint8_t threshold)
+bool CAP1188::setPowerState(uint8_t state)
 {
-    switch (buttonNumber)
+    uint8_t bits;
+    switch (state)
     {
-    case 1:
-        if (!_i2c)
-        {
-            // SPI
-            writeRegisterAtAddress(CAP1188_SENSOR_INPUT_1_THRESHOLD_REG, threshold);
-        }
-        else
-        {
-            // I2C
-            I2Cdev::writeByte(_i2cAddress, CAP1188_SENSOR_INPUT_1_THRESHOLD_REG, threshold);
-        }
+    case CAP1188_POWER_ACTIVE:
+        bits = 0x00;
         break;
 
-    case 2:
-        if (!_i2c)
+    case CAP1188_POWER_STANDBY:
+        bits = CAP1188_MAIN_CONTROL_STBY_BIT;
+        break;
+
+    case CAP1188_POWER_DEEP_SLEEP:
+        bits = CAP1188_MAIN_CONTROL_DSLEEP_BIT;
+        break;
+
+    default:
+        // Unknown power state received
+        return false;
+    }
+
+    CAP1188BusGuard guard(*this); // Read-modify-write is not interleaved with other bus users
+    uint8_t mainControl;
+    if (!readRegister(CAP1188_MAIN_CONTROL_REG, &mainControl))
+    {
+        return false;
+    }
+    mainControl = (mainControl & ~(CAP1188_MAIN_CONTROL_STBY_BIT | CAP1188_MAIN_CONTROL_DSLEEP_BIT)) | bits;
+    return writeRegister(CAP1188_MAIN_CONTROL_REG, mainControl);
+}
+
+/**
+ * @brief Returns power state of CAP1188 (taken from shadow register file if known)
+ * @return CAP1188_POWER_..., CAP1188_POWER_ACTIVE on error (see getLastStatus())
+ */
+uint8_t CAP1188::getPowerState()
+{
+    uint8_t mainControl;
+    if (!getShadow(CAP1188_MAIN_CONTROL_REG, &mainControl) && !readRegister(CAP1188_MAIN_CONTROL_REG, &mainControl))
+    {
+        return CAP1188_POWER_ACTIVE;
+    }
+    // Deep sleep takes precedence over standby
+    if (mainControl & CAP1188_MAIN_CONTROL_DSLEEP_BIT)
+    {
+        return CAP1188_POWER_DEEP_SLEEP;
+    }
+    return (mainControl & CAP1188_MAIN_CONTROL_STBY_BIT) ? CAP1188_POWER_STANDBY : CAP1188_POWER_ACTIVE;
+}
+#endif
+
+#if CAP1188_HAS_FEATURE(CAP1188_FEATURE_THRESHOLDS)
+/**
+ * @brief Writes data to Averaging and Sampling Configuration register that controls the number of samples taken and
+ * the total sensor input cycle time for all active sensor inputs while the device is functioning in Active state.
+ * @param samplesPerMeasurement Determines the number of samples that are taken for all active channels during the sensor cycle (use CAP1188_SAMPLES_PER_MEASUREMENT_...)
+ * @param samplingTime  Determines the time to take a single sample (use CAP1188_SAMPLING_TIME_...)
+ * @param cycleTime Determines the number of samples that are taken for all active channels during the sensor cycle (use CAP1188_CYCLE_TIME_...)
+ * @return true on success, false on error
+ */
+bool CAP1188::setAveragingAndSamplingConfig(uint8_t samplesPerMeasurement, uint8_t samplingTime, uint8_t cycleTime)
+{
+    uint8_t reg;
+    reg = CAP1188_AVERAGING_AND_SAMPLING_CONFIG(samplesPerMeasurement, samplingTime, cycleTime);
+    return writeRegister(CAP1188_AVERAGING_AND_SAMPLING_CONFIG_REG, reg);
+}
+
+/**
+ * @brief Reads data from Averaging and Sampling Configuration register that controls the number of samples taken and
+ * the total sensor input cycle time for all active sensor inputs while the device is functioning in Active state.
+ * @param samplesPerMeasurement buffer to receive "amount of samples per measurement" in to
+ * @param samplingTime buffer to receive "sampling time" in to
+ * @param cycleTime buffer to receive "cycle time" in to
+ * @return true on success, false on error
+ */
+bool CAP1188::getAveragingAndSamplingConfig(uint8_t *samplesPerMeasurement, uint8_t *samplingTime, uint8_t *cycleTime)
+{
+    uint8_t reg;
+    if (!readRegister(CAP1188_AVERAGING_AND_SAMPLING_CONFIG_REG, &reg))
+    {
+        return false;
+    }
+    *samplesPerMeasurement = (reg >> 4) & 0x07;
+    *samplingTime = (reg >> 2) & 0x03;
+    *cycleTime = reg & 0x03;
+    return true;
+}
+/**
+ * @brief Writes data to a specific Sensor Input Threshold register, which store the delta threshold that is used to determine if a touch has been detected.
+ * NOTE: With B7 (BUT_LD_TH) of RECALIBRATION CONFIGURATION REGISTER set (default), write to the 1st button threshold modifies all of them
+ * @param buttonNumber number of a button netween 1...8
+ * @param threshold threshold number (USE CAP1188_SENSOR_INPUT_THRESHOLD_...)
+ * @return true on success, false on error
+ */
+bool CAP1188::setSensorInputThreshold(uint8_t buttonNumber, uint8_t threshold)
+{
+    if (buttonNumber < 1 || buttonNumber > 8)
+    {
+        // Unknown button number received
+        return false;
+    }
+    return writeRegister(CAP1188_SENSOR_INPUT_1_THRESHOLD_REG + buttonNumber - 1, threshold);
+}
+
+/**
+ * @brief Writes data to all Sensor Input Threshold registers, which store the delta threshold that is used to determine if a touch has been detected.
+ * Makes use of B7 (BUT_LD_TH) of RECALIBRATION CONFIGURATION REGISTER, with which a write to the 1st Input register modifies all of them.
+ * Thresholds are verified by reading all of them back
+ * @param threshold threshold number (USE CAP1188_SENSOR_INPUT_THRESHOLD_...)
+ * @return true on success, false on error
+ */
+bool CAP1188::setSensorInputThresholdAll(uint8_t threshold)
+{
+    CAP1188BusGuard guard(*this);
+    uint8_t recalibrationConfig;
+    if (!getShadow(CAPP1188_RECALIBRATION_CONFIGURATION_REG, &recalibrationConfig) &&
+        !readRegister(CAPP1188_RECALIBRATION_CONFIGURATION_REG, &recalibrationConfig))
+    {
+        return false;
+    }
+
+    // B7 is set by default, so it only needs to be set (and restored afterwards) if it was cleared
+    bool restoreConfig = !(recalibrationConfig & CAP1188_RECALIBRATION_BUT_LD_TH_BIT);
+    if (restoreConfig &&
+        !writeRegister(CAPP1188_RECALIBRATION_CONFIGURATION_REG, recalibrationConfig | CAP1188_RECALIBRATION_BUT_LD_TH_BIT))
+    {
+        return false;
+    }
+
+    // Setting input threshold value to 1st Input register which will modify all of them
+    bool success = writeRegister(CAP1188_SENSOR_INPUT_1_THRESHOLD_REG, threshold);
+
+    if (restoreConfig && !writeRegister(CAPP1188_RECALIBRATION_CONFIGURATION_REG, recalibrationConfig))
+    {
+        success = false;
+    }
+
+    // Verify all thresholds at once
+    uint8_t thresholds[8];
+    if (!success || !getSensorInputThresholds(thresholds))
+    {
+        return false;
+    }
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        if (thresholds[i] != threshold)
         {
-            // SPI
-            writeRegisterAtAddress(CAP1188_SENSOR_INPUT_2_THRESHOLD_REG, threshold);
+            return false;
         }
-        else
+    }
+    return true;
+}
+
+/**
+ * @brief Reads data from Sensor Input Threshold registers, which store the delta threshold that is used to determine if a touch has been detected
+ * @param buttonNumber number of a button netween 1...8
+ * @return register content with selected button number threshold, 0 on error
+ */
+uint8_t CAP1188::getSensorInputThreshold(uint8_t buttonNumber)
+{
+    uint8_t reg;
+    if (buttonNumber < 1 || buttonNumber > 8)
+    {
+        // Unknown button received
+        return 0;
+    }
+    if (!readRegister(CAP1188_SENSOR_INPUT_1_THRESHOLD_REG + buttonNumber - 1, &reg))
+    {
+        return 0;
+    }
+    return reg;
+}
+
+/**
+ * @brief Writes data to all Sensor Input Threshold registers within a single bus transaction
+ * @param thresholds thresholds of sensor inputs 1...8 (USE CAP1188_SENSOR_INPUT_THRESHOLD_...)
+ * @return true on success, false on error
+ */
+bool CAP1188::setSensorInputThresholds(const uint8_t thresholds[8])
+{
+    // NOTE: With B7 of RECALIBRATION CONFIGURATION REGISTER set, write to the 1st Input register modifies all of them,
+    // but the rest of registers are overwritten by the same burst right after that
+    return writeRegisters(CAP1188_SENSOR_INPUT_1_THRESHOLD_REG, thresholds, 8);
+}
+
+/**
+ * @brief Reads data from all Sensor Input Threshold registers within a single bus transaction
+ * @param thresholds buffer to receive thresholds of sensor inputs 1...8 in to
+ * @return true on success, false on error
+ */
+bool CAP1188::getSensorInputThresholds(uint8_t thresholds[8])
+{
+    return readRegisters(CAP1188_SENSOR_INPUT_1_THRESHOLD_REG, thresholds, 8);
+}
+
+/**
+ * @brief Sets sensitivity of touch detection in active state (DELTA_SENSE bits of SENSITIVITY CONTROL REGISTER).
+ * BASE_SHIFT bits are kept as they are
+ * @param sensitivity use CAP1188_SENSITIVITY_... (CAP1188_SENSITIVITY_32X by default)
+ * @return true on success, false on error
+ */
+bool CAP1188::setSensitivity(uint8_t sensitivity)
+{
+    return modifyRegister(CAP1188_SENSITIVITY_CONTROL_REG, 0x70, (sensitivity & 0x07) << 4);
+}
+
+/**
+ * @brief Reads sensitivity of touch detection in active state
+ * @return CAP1188_SENSITIVITY_..., 0 on error (see getLastStatus())
+ */
+uint8_t CAP1188::getSensitivity()
+{
+    uint8_t reg;
+    if (!getShadow(CAP1188_SENSITIVITY_CONTROL_REG, &reg) && !readRegister(CAP1188_SENSITIVITY_CONTROL_REG, &reg))
+    {
+        return 0;
+    }
+    return (reg >> 4) & 0x07;
+}
+#endif
+
+#if CAP1188_HAS_FEATURE(CAP1188_FEATURE_COUNTS)
+/**
+ * @brief Reads Sensor Input Delta Count register of a single sensor input
+ * @param inputNumber number of a sensor input between 1...8
+ * @return delta count of a sensor input, 0 on error
+ */
+int8_t CAP1188::getDeltaCount(uint8_t inputNumber)
+{
+    uint8_t reg;
+    if (inputNumber < 1 || inputNumber > 8 || !readRegister(CAP1188_SENSOR_INPUT_1_DELTA_COUNT_REG + inputNumber - 1, &reg))
+    {
+        return 0;
+    }
+    return (int8_t)reg;
+}
+
+/**
+ * @brief Reads Sensor Input Base Count register of a single sensor input
+ * @param inputNumber number of a sensor input between 1...8
+ * @return base count of a sensor input, 0 on error
+ */
+uint8_t CAP1188::getBaseCount(uint8_t inputNumber)
+{
+    uint8_t reg;
+    if (inputNumber < 1 || inputNumber > 8 || !readRegister(CAP1188_SENSOR_INPUT_1_BASE_COUNT_REG + inputNumber - 1, &reg))
+    {
+        return 0;
+    }
+    return reg;
+}
+
+/**
+ * @brief Reads 10-bit calibration value of a single sensor input (upper 8 bits from Sensor Input Calibration register,
+ * lower 2 bits from Sensor Input Calibration LSB register)
+ * @param inputNumber number of a sensor input between 1...8
+ * @return calibration value of a sensor input, 0 on error
+ */
+uint16_t CAP1188::getCalibration(uint8_t inputNumber)
+{
+    uint8_t msb, lsb;
+    if (inputNumber < 1 || inputNumber > 8)
+    {
+        return 0;
+    }
+    // Every LSB register holds 2 bits of each of 4 sensor inputs
+    if (!readRegister(CAP1188_SENSOR_INPUT_1_CALIBRATION_REG + inputNumber - 1, &msb) ||
+        !readRegister(CAP1188_SENSOR_INPUT_CALIBRATION_LSB_1_REG + (inputNumber - 1) / 4, &lsb))
+    {
+        return 0;
+    }
+    return (uint16_t)msb << 2 | ((lsb >> (2 * ((inputNumber - 1) % 4))) & 0x03);
+}
+
+/**
+ * @brief Decodes 10-bit calibration value of a sensor input from SENSOR INPUT CALIBRATION registers (0xB1-0xBA)
+ * @param regs contents of 10 calibration registers
+ * @param index index of a sensor input between 0...7
+ * @return calibration value
+ */
+static uint16_t calibrationValue(const uint8_t regs[10], uint8_t index)
+{
+    return (uint16_t)regs[index] << 2 | ((regs[8 + index / 4] >> (2 * (index % 4))) & 0x03);
+}
+
+/**
+ * @brief Reads 10-bit calibration values of all sensor inputs within a single bus transaction (0xB1-0xBA)
+ * @param calibrations buffer to receive calibration values of sensor inputs 1...8 in to
+ * @return true on success, false on error
+ */
+bool CAP1188::getCalibrations(uint16_t calibrations[8])
+{
+    uint8_t regs[10];
+    if (!readRegisters(CAP1188_SENSOR_INPUT_1_CALIBRATION_REG, regs, sizeof(regs)))
+    {
+        return false;
+    }
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        calibrations[i] = calibrationValue(regs, i);
+    }
+    return true;
+}
+
+/**
+ * @brief Starts calibration of selected sensor inputs (CALIBRATION ACTIVATE REGISTER). Only selected inputs stop sensing
+ * while calibrating, so it is cheaper than recalibrating the whole chip
+ * @param inputs sensor inputs to calibrate in binary format (i.e. 0b00000101 for inputs 1 and 3)
+ * @return true on success, false on error
+ */
+bool CAP1188::recalibrate(uint8_t inputs)
+{
+    return writeRegister(CAP1188_CALIBRATION_ACTIVATE_REG, inputs);
+}
+
+/**
+ * @brief Reads sensor inputs, which are still calibrating (bits of CALIBRATION ACTIVATE REGISTER are cleared by CAP1188 when done)
+ * @return calibrating inputs in binary format, 0 if none or on error
+ */
+uint8_t CAP1188::getCalibratingInputs()
+{
+    uint8_t reg;
+    if (!readRegister(CAP1188_CALIBRATION_ACTIVATE_REG, &reg))
+    {
+        return 0;
+    }
+    return reg;
+}
+
+/**
+ * @brief Takes a snapshot of sensing configuration (sensitivity, configuration, thresholds) together with calibration and
+ * base counts of all sensor inputs, which can be stored as is (i.e. in NVS/EEPROM) and restored at boot by
+ * restoreCalibration(...). Every register block is read within a single burst
+ * @param snapshot buffer to receive snapshot in to
+ * @return true on success, false on error
+ */
+bool CAP1188::saveCalibration(CAP1188CalibrationSnapshot *snapshot)
+{
+    CAP1188BusGuard guard(*this); // Snapshot is not interleaved with other bus users
+    snapshot->version = CAP1188_CALIBRATION_SNAPSHOT_VERSION;
+    return readRegisters(CAP1188_SENSITIVITY_CONTROL_REG, snapshot->config, sizeof(snapshot->config)) &&
+           readRegisters(CAP1188_SENSOR_INPUT_1_THRESHOLD_REG, snapshot->thresholds, sizeof(snapshot->thresholds)) &&
+           readRegisters(CAP1188_SENSOR_INPUT_1_BASE_COUNT_REG, snapshot->baseCounts, sizeof(snapshot->baseCounts)) &&
+           readRegisters(CAP1188_SENSOR_INPUT_1_CALIBRATION_REG, snapshot->calibration, sizeof(snapshot->calibration));
+}
+
+/**
+ * @brief Restores a snapshot taken by saveCalibration(...). Sensing configuration is written in bursts (only registers
+ * differing from shadow register file), then live calibration is compared against the snapshot.
+ * NOTE: Calibration and base count registers of CAP1188 are read-only, so they cannot be written back. Instead only
+ * inputs, calibration of which differs by more than tolerance, are recalibrated (see recalibrate(...)), inputs matching
+ * the snapshot are valid right away. Inputs, which are still calibrating, are not compared
+ * @param snapshot snapshot to restore
+ * @param tolerance maximum difference of 10-bit calibration values, at which an input is not recalibrated
+ * @return true on success, false on error or if snapshot version does not match
+ */
+bool CAP1188::restoreCalibration(const CAP1188CalibrationSnapshot &snapshot, uint16_t tolerance)
+{
+    if (snapshot.version != CAP1188_CALIBRATION_SNAPSHOT_VERSION)
+    {
+        return false;
+    }
+    CAP1188BusGuard guard(*this);
+    if (!writeChangedRegisters(CAP1188_SENSITIVITY_CONTROL_REG, snapshot.config, sizeof(snapshot.config)) ||
+        !writeChangedRegisters(CAP1188_SENSOR_INPUT_1_THRESHOLD_REG, snapshot.thresholds, sizeof(snapshot.thresholds)))
+    {
+        return false;
+    }
+
+    uint8_t calibrating, regs[10];
+    if (!readRegister(CAP1188_CALIBRATION_ACTIVATE_REG, &calibrating) ||
+        !readRegisters(CAP1188_SENSOR_INPUT_1_CALIBRATION_REG, regs, sizeof(regs)))
+    {
+        return false;
+    }
+    uint8_t drifted = 0;
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        int16_t difference = (int16_t)calibrationValue(regs, i) - (int16_t)calibrationValue(snapshot.calibration, i);
+        if (!(calibrating & (1 << i)) && (difference > (int16_t)tolerance || difference < -(int16_t)tolerance))
         {
-            // I2C
-            I2Cdev::writeByte(_i2cAddress, CAP1188_SENSOR_INPUT_2_THRESHOLD_REG, threshold);
+            drifted |= 1 << i;
         }
-        break;
+    }
+    return drifted == 0 || recalibrate(drifted);
+}
+#endif
 
-    case 3:
-        if (!_i2c)
+/**
+ * @brief Reads several consecutive registers within a single bus transaction (SPI register pointer auto-increment or I2C sequential read)
+ * @param startAddress first register address to read from
+ * @param buff buffer to receive register contents in to (must fit len bytes)
+ * Failed transfers are retried according to setRetryPolicy(...), result of the last attempt is available via getLastStatus()
+ * @param len amount of registers to read
+ * @return true on success, false on error
+ */
+bool CAP1188_HOT_ATTR CAP1188::readRegisters(uint8_t startAddress, uint8_t* buff, uint8_t len)
+{
+    CAP1188_STATS(uint32_t startTime = micros());
+    for (uint8_t attempt = 0;; attempt++)
+    {
+        lockBus(); // Lock is only held for a single attempt, not during backoff
+        _lastStatus = busReadRegisters(startAddress, buff, len);
+        unlockBus();
+        if (!retryAfter(attempt))
         {
-            // SPI
-            writeRegisterAtAddress(CAP1188_SENSOR_INPUT_3_THRESHOLD_REG, threshold);
+            break;
         }
-        else
+    }
+    bool success = _lastStatus == CAP1188_STATUS_OK;
+    CAP1188_STATS(recordStats(len > 1 ? CAP1188_STATS_BURST_READ : CAP1188_STATS_READ, len, success, micros() - startTime));
+    if (!success)
+    {
+        return false;
+    }
+    updateShadow(startAddress, buff, len);
+    return true;
+}
+
+/**
+ * @brief Writes several consecutive registers within a single bus transaction (SPI register pointer auto-increment or I2C sequential write)
+ * @param startAddress first register address to write to
+ * @param buff buffer with register contents to write (must contain len bytes)
+ * Failed transfers are retried according to setRetryPolicy(...), result of the last attempt is available via getLastStatus()
+ * @param len amount of registers to write
+ * @return true on success, false on error
+ */
+bool CAP1188_HOT_ATTR CAP1188::writeRegisters(uint8_t startAddress, const uint8_t* buff, uint8_t len)
+{
+    CAP1188_STATS(uint32_t startTime = micros());
+    for (uint8_t attempt = 0;; attempt++)
+    {
+        lockBus(); // Lock is only held for a single attempt, not during backoff
+        _lastStatus = busWriteRegisters(startAddress, buff, len);
+        unlockBus();
+        if (!retryAfter(attempt))
         {
-            // I2C
-            I2Cdev::writeByte(_i2cAddress, CAP1188_SENSOR_INPUT_3_THRESHOLD_REG, threshold);
+            break;
         }
-        break;
+    }
+    bool success = _lastStatus == CAP1188_STATUS_OK;
+    CAP1188_STATS(recordStats(len > 1 ? CAP1188_STATS_BURST_WRITE : CAP1188_STATS_WRITE, len, success, micros() - startTime));
+    if (!success)
+    {
+        return false;
+    }
+    updateWrittenShadow(startAddress, buff, len);
+    return true;
+}
+
+/**
+ * @brief Reads several consecutive registers and writes several other consecutive registers within a single bus transaction.
+ * Failed transfers are retried according to setRetryPolicy(...)
+ * @param readAddress first register address to read from
+ * @param readBuff buffer to receive register contents in to (must fit readLen bytes)
+ * @param readLen amount of registers to read (up to CAP1188_MAX_BURST_LENGTH)
+ * @param writeAddress first register address to write to
+ * @param writeBuff buffer with register contents to write (must contain writeLen bytes)
+ * @param writeLen amount of registers to write (up to CAP1188_I2C_BUFFER_LENGTH - 1)
+ * @return true on success, false on error
+ */
+bool CAP1188::exchangeRegisters(uint8_t readAddress, uint8_t* readBuff, uint8_t readLen, uint8_t writeAddress, const uint8_t* writeBuff, uint8_t writeLen)
+{
+    CAP1188_STATS(uint32_t startTime = micros());
+    for (uint8_t attempt = 0;; attempt++)
+    {
+        lockBus(); // Lock is only held for a single attempt, not during backoff
+        _lastStatus = busExchangeRegisters(readAddress, readBuff, readLen, writeAddress, writeBuff, writeLen);
+        unlockBus();
+        if (!retryAfter(attempt))
+        {
+            break;
+        }
+    }
+    bool success = _lastStatus == CAP1188_STATUS_OK;
+    CAP1188_STATS(recordStats(CAP1188_STATS_EXCHANGE, readLen + writeLen, success, micros() - startTime));
+    if (!success)
+    {
+        return false;
+    }
+    updateShadow(readAddress, readBuff, readLen);
+    updateWrittenShadow(writeAddress, writeBuff, writeLen);
+    return true;
+}
+
+/**
+ * @brief Updates shadow register file after registers were written (including thresholds changed by CAP1188 itself)
+ * @param startAddress first register address written
+ * @param buff register contents written
+ * @param len amount of registers written
+ * @return void
+ */
+void CAP1188_HOT_ATTR CAP1188::updateWrittenShadow(uint8_t startAddress, const uint8_t* buff, uint8_t len)
+{
+    updateShadow(startAddress, buff, len);
+    if (startAddress <= CAP1188_SENSOR_INPUT_1_THRESHOLD_REG && startAddress + len > CAP1188_SENSOR_INPUT_1_THRESHOLD_REG)
+    {
+        broadcastThresholdShadow(buff[CAP1188_SENSOR_INPUT_1_THRESHOLD_REG - startAddress], startAddress + len);
+    }
+}
 
-    case 4:
-        if (!_i2c)
+/**
+ * @brief Keeps shadow register file in line with CAP1188 after the 1st Input threshold register was written: with B7 (BUT_LD_TH)
+ * of RECALIBRATION CONFIGURATION REGISTER set, CAP1188 copies it into thresholds of all other inputs
+ * @param threshold threshold written to the 1st Input register
+ * @param endAddress first register address after the written ones (registers before it were overwritten by the same write)
+ * @return void
+ */
+void CAP1188::broadcastThresholdShadow(uint8_t threshold, uint16_t endAddress)
+{
+    uint8_t recalibrationConfig;
+    bool known = getShadow(CAPP1188_RECALIBRATION_CONFIGURATION_REG, &recalibrationConfig);
+    if (known && !(recalibrationConfig & CAP1188_RECALIBRATION_BUT_LD_TH_BIT))
+    {
+        return;
+    }
+    for (uint16_t regAddress = endAddress; regAddress <= CAP1188_SENSOR_INPUT_8_THRESHOLD_REG; regAddress++)
+    {
+        int8_t index = shadowIndex(regAddress);
+        if (known)
         {
-            // SPI
-            writeRegisterAtAddress(CAP1188_SENSOR_INPUT_4_THRESHOLD_REG, threshold);
+            _shadow[index] = threshold;
         }
         else
         {
-            // I2C
-            I2Cdev::writeByte(_i2cAddress, CAP1188_SENSOR_INPUT_4_THRESHOLD_REG, threshold);
+            // Not known if thresholds were modified
+            _shadowValid[index >> 3] &= ~(1 << (index & 0x07));
         }
-        break;
+    }
+}
+
+/**
+ * @brief Re-reads all registers kept in shadow register file from CAP1188. Useful after CAP1188 was reset or configured bypassing this driver.
+ * NOTE: Shadow register file is also filled in lazily - whenever a shadowed register is read or written
+ * @return true on success, false on error
+ */
+bool CAP1188_COLD_ATTR CAP1188::syncShadow()
+{
+    uint8_t offset = 0;
+    for (uint8_t i = 0; i < sizeof(shadowRanges) / sizeof(shadowRanges[0]); i++)
+    {
+        // Data is read straight into shadow register file and then marked as valid by updateShadow(...)
+        if (!readRegisters(shadowRanges[i].start, &_shadow[offset], shadowRanges[i].len))
+        {
+            return false;
+        }
+        offset += shadowRanges[i].len;
+    }
+    return true;
+}
+
+/**
+ * @brief Applies a configuration profile. Registers are compared against shadow register file and only changed ones
+ * (or ones with unknown state) are written, consecutive registers within a single burst
+ * @param config configuration profile to apply
+ * @return true on success, false on error
+ */
+bool CAP1188_COLD_ATTR CAP1188::applyConfig(const CAP1188Config &config)
+{
+    return writeChangedRegisters(CAP1188_AVERAGING_AND_SAMPLING_CONFIG_REG, &config.averagingAndSampling, 1) &&
+           writeChangedRegisters(CAP1188_MULTIPLE_TOUCH_CONFIGURATION_REG, &config.multipleTouch, 1) &&
+           writeChangedRegisters(CAP1188_SENSOR_INPUT_1_THRESHOLD_REG, config.thresholds, 8) &&
+           writeChangedRegisters(CAP1188_STANDBY_CONFIGURATION_REG, &config.standby, 1) &&
+           writeChangedRegisters(CAP1188_SENSOR_INPUT_LED_LINKING_REG, &config.ledLinking, 1);
+}
+
+#if CAP1188_HAS_FEATURE(CAP1188_FEATURE_LED)
+/**
+ * @brief Programs LED engine of CAP1188 (behavior, pulse/breathe periods, pulse counts, duty cycles, ramp rates and off delays).
+ * Same as applyConfig(...), only changed registers are written and consecutive ones within a single burst
+ * @param config LED engine configuration to apply
+ * @return true on success, false on error
+ */
+bool CAP1188::applyLedConfig(const CAP1188LedConfig &config)
+{
+    return writeChangedRegisters(CAP1188_LED_BEHAVIOR_1_REG, config.behavior, 2) &&
+           writeChangedRegisters(CAP1188_LED_PULSE_1_PERIOD_REG, &config.pulse1Period, 3) &&
+           writeChangedRegisters(CAP1188_LED_CONFIG_REG, &config.pulseCounts, 1) &&
+           writeChangedRegisters(CAP1188_LED_PULSE_1_DUTY_CYCLE_REG, &config.pulse1Duty, 6);
+}
+
+/**
+ * @brief Sets behavior of a single LED
+ * @param ledNumber number of a LED between 1...8
+ * @param behavior use CAP1188_LED_BEHAVIOR_...
+ * @return true on success, false on error
+ */
+bool CAP1188::setLedBehavior(uint8_t ledNumber, uint8_t behavior)
+{
+    if (ledNumber < 1 || ledNumber > 8)
+    {
+        return false;
+    }
+    uint8_t shift = 2 * ((ledNumber - 1) % 4);
+    return modifyRegister(CAP1188_LED_BEHAVIOR_1_REG + (ledNumber - 1) / 4, 0x03 << shift, behavior << shift);
+}
+
+/**
+ * @brief Sets state of all directly controlled LEDs (LED OUTPUT CONTROL REGISTER). Change is only buffered,
+ * so several modules can update LEDs without bus traffic; it is written by flushLeds() or getSensorInputsAndFlushLeds()
+ * @param leds LEDs to turn on in binary format (i.e. 0b00000101 for LED1 and LED3)
+ * @return void
+ */
+void CAP1188::setLeds(uint8_t leds)
+{
+    if (leds != _leds)
+    {
+        _leds = leds;
+        _ledsDirty = true;
+    }
+}
+
+/**
+ * @brief Sets state of a single directly controlled LED. Change is only buffered (see setLeds(...))
+ * @param ledNumber number of a LED between 1...8
+ * @param on true to turn LED on, false to turn it off
+ * @return true on success, false if LED number is wrong
+ */
+bool CAP1188::setLed(uint8_t ledNumber, bool on)
+{
+    if (ledNumber < 1 || ledNumber > 8)
+    {
+        return false;
+    }
+    uint8_t mask = 1 << (ledNumber - 1);
+    setLeds(on ? (_leds | mask) : (_leds & ~mask));
+    return true;
+}
+
+/**
+ * @brief Returns buffered state of directly controlled LEDs (including changes, which are not flushed yet)
+ * @return LEDs turned on in binary format
+ */
+uint8_t CAP1188::getLeds()
+{
+    return _leds;
+}
+
+/**
+ * @brief Writes buffered LED state to CAP1188 if it was changed since the last flush. Meant to be called once per loop iteration
+ * @return true on success (or if nothing had to be written), false on error (change stays buffered)
+ */
+bool CAP1188::flushLeds()
+{
+    if (!_ledsDirty)
+    {
+        return true;
+    }
+    if (!writeChangedRegisters(CAP1188_LED_OUTPUT_CONTROL_REG, &_leds, 1))
+    {
+        return false;
+    }
+    _ledsDirty = false;
+    return true;
+}
+
+/**
+ * @brief Same as getSensorInputs(), but buffered LED state is written within the same bus transaction if it was changed
+ * (single CS frame on SPI, repeated start on I2C)
+ * @return keys pressed in binary format, 0 on error (see getLastStatus())
+ */
+uint8_t CAP1188::getSensorInputsAndFlushLeds()
+{
+    CAP1188BusGuard guard(*this);
+    uint8_t ledReg;
+    if (!_ledsDirty || (getShadow(CAP1188_LED_OUTPUT_CONTROL_REG, &ledReg) && ledReg == _leds))
+    {
+        _ledsDirty = false;
+        return getSensorInputs();
+    }
+
+    uint8_t keys;
+    if (!exchangeRegisters(CAP1188_SENSOR_INPUT_STATUS_REG, &keys, 1, CAP1188_LED_OUTPUT_CONTROL_REG, &_leds, 1))
+    {
+        return 0;
+    }
+    _ledsDirty = false;
+    if (keys)
+    {
+        clearInterrupt();
+    }
+    return keys;
+}
+#endif
+
+#if !defined(ESP32) && !defined(ESP8266)
+CAP1188 *CAP1188::_alertDevices[CAP1188_MAX_ALERT_DEVICES];
+
+/**
+ * @brief ALERT pin interrupt handler of a slot, used on cores without attachInterruptArg(...)
+ * @return void
+ */
+template <uint8_t slot>
+void CAP1188::alertSlotISR()
+{
+    alertISR(_alertDevices[slot]);
+}
+
+static_assert(CAP1188_MAX_ALERT_DEVICES == 4, "_alertSlotISRs has to hold a handler per slot");
+void (*const CAP1188::_alertSlotISRs[CAP1188_MAX_ALERT_DEVICES])() = {
+    alertSlotISR<0>,
+    alertSlotISR<1>,
+    alertSlotISR<2>,
+    alertSlotISR<3>,
+};
+#endif
+
+/**
+ * @brief Enables interrupt driven mode. Falling edge on ALERT pin marks CAP1188 to be serviced by processAlert(),
+ * which reads sensor inputs, clears INT and reports changes as press/release events (see readEvent(...)).
+ * NOTE: Bus is never accessed from the interrupt itself - call processAlert() from a loop or a task (see startTask(...) on ESP32)
+ * @param alertPin GPIO connected to ALERT pin of CAP1188 (ALERT is active low and push-pull by default)
+ * @return true on success, false if CAP1188_MAX_ALERT_DEVICES devices are in interrupt driven mode already
+ * (only on cores without attachInterruptArg(...))
+ */
+bool CAP1188::attachAlert(uint8_t alertPin)
+{
+    detachAlert();
+#if !defined(ESP32) && !defined(ESP8266)
+    uint8_t slot = 0;
+    while (slot < CAP1188_MAX_ALERT_DEVICES && _alertDevices[slot])
+    {
+        slot++;
+    }
+    if (slot == CAP1188_MAX_ALERT_DEVICES)
+    {
+        return false;
+    }
+    _alertDevices[slot] = this;
+#endif
+    _alertPin = alertPin;
+    _alertPending = false;
+    _lastInputs = 0;
+    _events.clear();
+
+    pinMode(_alertPin, INPUT_PULLUP);
+#if defined(ESP32) || defined(ESP8266)
+    attachInterruptArg(digitalPinToInterrupt(_alertPin), alertISR, this, FALLING);
+#else
+    attachInterrupt(digitalPinToInterrupt(_alertPin), _alertSlotISRs[slot], FALLING);
+#endif
+
+    // ALERT might have been asserted already, in which case no falling edge would ever come
+    if (digitalRead(_alertPin) == LOW)
+    {
+        _alertTimestamp = millis();
+        _alertPending = true;
+    }
+    return true;
+}
+
+/**
+ * @brief Disables interrupt driven mode
+ * @return void
+ */
+void CAP1188::detachAlert()
+{
+    if (_alertPin < 0)
+    {
+        return;
+    }
+    detachInterrupt(digitalPinToInterrupt(_alertPin));
+#if !defined(ESP32) && !defined(ESP8266)
+    for (uint8_t slot = 0; slot < CAP1188_MAX_ALERT_DEVICES; slot++)
+    {
+        if (_alertDevices[slot] == this)
+        {
+            _alertDevices[slot] = NULL;
+        }
+    }
+#endif
+    _alertPin = -1;
+    _alertPending = false;
+}
+
+/**
+ * @brief Services ALERT if it was asserted: reads status and sensor inputs, clears INT and pushes press/release (and pattern) events
+ * of inputs, which changed since the last serviced ALERT
+ * @return true if ALERT was serviced, false if ALERT was not asserted or bus error occurred
+ */
+bool CAP1188::processAlert()
+{
+    if (!_alertPending)
+    {
+        return false;
+    }
+    _alertPending = false;
+    uint32_t timestamp = _alertTimestamp;
+    CAP1188BusGuard guard(*this);
+
+    // GENERAL STATUS (0x02) and SENSOR INPUT STATUS (0x03) within a single burst
+    uint8_t status[2];
+    if (!readRegisters(CAP1188_GENERAL_STATUS_REG, status, sizeof(status)))
+    {
+        // Try again next time
+        _alertPending = true;
+        return false;
+    }
+    uint8_t inputs = status[1];
+
+    // Bring INT down even if no inputs are touched (release also asserts ALERT)
+    clearInterrupt();
+
+    pushInputEvents(inputs, timestamp);
+    if (status[0] & CAP1188_GENERAL_STATUS_MTP_BIT)
+    {
+        CAP1188Event event;
+        event.timestamp = timestamp;
+        event.type = CAP1188_EVENT_PATTERN;
+        event.input = inputs;
+        _events.push(event);
+    }
+    return true;
+}
+
+/**
+ * @brief Reads the oldest touch event reported in interrupt driven mode
+ * @param event buffer to receive event in to
+ * @return true if event was read, false if there are no events
+ */
+bool CAP1188::readEvent(CAP1188Event *event)
+{
+    return _events.pop(event);
+}
+
+/**
+ * @brief Returns amount of touch events, which can be read by readEvent(...)
+ * @return amount of events
+ */
+uint8_t CAP1188::eventsAvailable()
+{
+    return _events.available();
+}
+
+/**
+ * @brief Checks if interrupt driven mode is enabled by attachAlert(...)
+ * @return true if ALERT pin is attached, false otherwise
+ */
+bool CAP1188::isAlertAttached()
+{
+    return _alertPin >= 0;
+}
 
-    case 5:
-        if (!_i2c)
+/**
+ * @brief Checks if ALERT was asserted and is waiting to be serviced by processAlert()
+ * @return true if ALERT is pending, false otherwise
+ */
+bool CAP1188::isAlertPending()
+{
+    return _alertPending;
+}
+
+/**
+ * @brief Returns sensor inputs read by the last serviced ALERT (no bus access). In interrupt driven mode this is
+ * the current touch state, as every change of sensor inputs asserts ALERT
+ * @return keys pressed in binary format
+ */
+uint8_t CAP1188::getLastSensorInputs()
+{
+    return _lastInputs;
+}
+
+#if defined(ESP32)
+/**
+ * @brief Starts a FreeRTOS task, which owns the bus for asynchronous operations: it calls processAlert() as soon as
+ * ALERT is asserted and executes requests queued by ...Async(...) functions, reporting results via callbacks.
+ * Task holds bus lock while servicing a request, so it is serialised with callers from other tasks. If no lock is set
+ * (see setBusMutex(...), setBusLock(...)), a recursive mutex is created for it. Lock must not be changed while task is running
+ * @param stackSize task stack size in bytes
+ * @param priority task priority
+ * @param core core to pin task to (tskNO_AFFINITY to let scheduler decide)
+ * @return true on success, false on error
+ */
+bool CAP1188::startTask(uint32_t stackSize, UBaseType_t priority, BaseType_t core)
+{
+    if (_task)
+    {
+        return true;
+    }
+    if (!_busMutex && !_lock)
+    {
+        _busMutex = xSemaphoreCreateRecursiveMutex();
+        if (!_busMutex)
         {
-            // SPI
-            writeRegisterAtAddress(CAP1188_SENSOR_INPUT_5_THRESHOLD_REG, threshold);
+            return false;
         }
-        else
+        _ownBusMutex = true;
+    }
+    _queue = xQueueCreate(CAP1188_ASYNC_QUEUE_LENGTH, sizeof(CAP1188AsyncRequest));
+    if (!_queue || xTaskCreatePinnedToCore(taskLoop, "CAP1188", stackSize, this, priority, &_task, core) != pdPASS)
+    {
+        if (_queue)
         {
-            // I2C
-            I2Cdev::writeByte(_i2cAddress, CAP1188_SENSOR_INPUT_5_THRESHOLD_REG, threshold);
+            vQueueDelete(_queue);
+            _queue = NULL;
         }
-        break;
+        _task = NULL;
+        releaseBusMutex();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Stops the task started by startTask(...). Requests queued before are still executed (and their callbacks called)
+ * NOTE: Must not be called from a callback (task cannot wait for itself to exit)
+ * @return true if task is not running anymore, false if called from the task itself
+ */
+bool CAP1188::stopTask()
+{
+    if (!_task)
+    {
+        return true;
+    }
+    if (xTaskGetCurrentTaskHandle() == _task)
+    {
+        return false;
+    }
+    SemaphoreHandle_t done = xSemaphoreCreateBinary();
+    if (!done)
+    {
+        return false;
+    }
+    // No further requests (or ALERT wake-ups) are queued from now on
+    _taskStopping = true;
+
+    CAP1188AsyncRequest request;
+    request.operation = CAP1188_ASYNC_STOP;
+    request.callback = NULL;
+    request.arg = done;
+    xQueueSend(_queue, &request, portMAX_DELAY);
+    xSemaphoreTake(done, portMAX_DELAY);
+
+    vSemaphoreDelete(done);
+    vQueueDelete(_queue);
+    _queue = NULL;
+    _task = NULL;
+    _taskStopping = false;
+    releaseBusMutex();
+    return true;
+}
+
+/**
+ * @brief Checks if the task started by startTask(...) is running (it services ALERT then)
+ * @return true if task is running, false otherwise
+ */
+bool CAP1188::isTaskRunning()
+{
+    return _task != NULL;
+}
+
+/**
+ * @brief Deletes bus mutex created by startTask(...), if any
+ * @return void
+ */
+void CAP1188::releaseBusMutex()
+{
+    if (_ownBusMutex)
+    {
+        vSemaphoreDelete(_busMutex);
+        _busMutex = NULL;
+        _ownBusMutex = false;
+    }
+}
+
+/**
+ * @brief Queues a read of several consecutive registers to be executed by the task started by startTask(...)
+ * @param startAddress first register address to read from
+ * @param len amount of registers to read (up to CAP1188_MAX_BURST_LENGTH)
+ * @param callback function called from the task with register contents once read is done
+ * @param arg user argument passed to callback
+ * @return true if request was queued, false if task is not started, queue is full or len is too long
+ */
+bool CAP1188::readRegistersAsync(uint8_t startAddress, uint8_t len, CAP1188Callback callback, void *arg)
+{
+    CAP1188AsyncRequest request;
+    if (len > CAP1188_MAX_BURST_LENGTH)
+    {
+        return false;
+    }
+    request.operation = CAP1188_ASYNC_READ;
+    request.startAddress = startAddress;
+    request.len = len;
+    request.callback = callback;
+    request.arg = arg;
+    return queueRequest(request);
+}
+
+/**
+ * @brief Queues a write of several consecutive registers to be executed by the task started by startTask(...)
+ * @param startAddress first register address to write to
+ * @param buff buffer with register contents to write (copied, so it can be reused right away)
+ * @param len amount of registers to write (up to CAP1188_MAX_BURST_LENGTH)
+ * @param callback function called from the task once write is done (can be NULL)
+ * @param arg user argument passed to callback
+ * @return true if request was queued, false if task is not started, queue is full or len is too long
+ */
+bool CAP1188::writeRegistersAsync(uint8_t startAddress, const uint8_t *buff, uint8_t len, CAP1188Callback callback, void *arg)
+{
+    CAP1188AsyncRequest request;
+    if (len > CAP1188_MAX_BURST_LENGTH)
+    {
+        return false;
+    }
+    request.operation = CAP1188_ASYNC_WRITE;
+    request.startAddress = startAddress;
+    request.len = len;
+    memcpy(request.data, buff, len);
+    request.callback = callback;
+    request.arg = arg;
+    return queueRequest(request);
+}
+
+/**
+ * @brief Queues getSensorInputs() to be executed by the task started by startTask(...)
+ * @param callback function called from the task with keys pressed (single byte) once read is done
+ * @param arg user argument passed to callback
+ * @return true if request was queued, false if task is not started or queue is full
+ */
+bool CAP1188::getSensorInputsAsync(CAP1188Callback callback, void *arg)
+{
+    CAP1188AsyncRequest request;
+    request.operation = CAP1188_ASYNC_SENSOR_INPUTS;
+    request.len = 1;
+    request.callback = callback;
+    request.arg = arg;
+    return queueRequest(request);
+}
+
+/**
+ * @brief Queues a request for the task started by startTask(...) without waiting for a free slot
+ * @param request request to queue
+ * @return true on success, false if task is not started or queue is full
+ */
+bool CAP1188::queueRequest(const CAP1188AsyncRequest &request)
+{
+    if (!_queue || _taskStopping)
+    {
+        return false;
+    }
+    return xQueueSend(_queue, &request, 0) == pdTRUE;
+}
 
-    case 6:
-        if (!_i2c)
+/**
+ * @brief FreeRTOS task started by startTask(...)
+ * @param arg CAP1188 object
+ * @return void
+ */
+void CAP1188::taskLoop(void *arg)
+{
+    CAP1188 *cap1188 = (CAP1188 *)arg;
+    CAP1188AsyncRequest request;
+    for (;;)
+    {
+        if (xQueueReceive(cap1188->_queue, &request, portMAX_DELAY) != pdTRUE)
         {
-            // SPI
-            writeRegisterAtAddress(CAP1188_SENSOR_INPUT_6_THRESHOLD_REG, threshold);
+            continue;
         }
-        else
+        if (request.operation == CAP1188_ASYNC_STOP)
         {
-            // I2C
-            I2Cdev::writeByte(_i2cAddress, CAP1188_SENSOR_INPUT_6_THRESHOLD_REG, threshold);
+            // Object must not be touched once semaphore is given, as it might be destroyed right away
+            xSemaphoreGive((SemaphoreHandle_t)request.arg);
+            vTaskDelete(NULL);
+            return;
         }
-        break;
 
-    case 7:
-        if (!_i2c)
+        bool success = true;
+        cap1188->lockBus();
+        switch (request.operation)
         {
-            // SPI
-            writeRegisterAtAddress(CAP1188_SENSOR_INPUT_7_THRESHOLD_REG, threshold);
+        case CAP1188_ASYNC_READ:
+            success = cap1188->readRegisters(request.startAddress, request.data, request.len);
+            break;
+
+        case CAP1188_ASYNC_WRITE:
+            success = cap1188->writeRegisters(request.startAddress, request.data, request.len);
+            break;
+
+        case CAP1188_ASYNC_SENSOR_INPUTS:
+            // Success of the status read itself, trailing INT clear does not make read data invalid
+            success = cap1188->readSensorInputs(request.data);
+            break;
+
+        default:
+            break;
         }
-        else
+        cap1188->unlockBus();
+
+        if (request.operation != CAP1188_ASYNC_ALERT && request.callback)
         {
-            // I2C
-            I2Cdev::writeByte(_i2cAddress, CAP1188_SENSOR_INPUT_7_THRESHOLD_REG, threshold);
+            request.callback(request.arg, success, request.data, request.len);
         }
-        break;
 
-    case 8:
-        if (!_i2c)
+        // ALERT might have been asserted while queue was full, so it is checked after every request
+        cap1188->processAlert();
+    }
+}
+#endif
+
+/**
+ * @brief ALERT pin interrupt handler. Only marks CAP1188 to be serviced, bus is accessed later by processAlert()
+ * @param arg CAP1188 object
+ * @return void
+ */
+void CAP1188_ISR_ATTR CAP1188::alertISR(void *arg)
+{
+    CAP1188 *cap1188 = (CAP1188 *)arg;
+    cap1188->_alertTimestamp = millis();
+    cap1188->_alertPending = true;
+#if defined(ESP32)
+    if (cap1188->_queue && !cap1188->_taskStopping)
+    {
+        // Wake up the task (request itself carries no data)
+        CAP1188AsyncRequest request;
+        request.operation = CAP1188_ASYNC_ALERT;
+        BaseType_t higherPriorityTaskWoken = pdFALSE;
+        xQueueSendFromISR(cap1188->_queue, &request, &higherPriorityTaskWoken);
+        if (higherPriorityTaskWoken)
         {
-            // SPI
-            writeRegisterAtAddress(CAP1188_SENSOR_INPUT_8_THRESHOLD_REG, threshold);
+            portYIELD_FROM_ISR();
         }
-        else
+    }
+#endif
+}
+
+/**
+ * @brief Pushes press/release events for every sensor input, which changed since the last call
+ * @param inputs current sensor inputs
+ * @param timestamp event timestamp
+ * @return void
+ */
+void CAP1188::pushInputEvents(uint8_t inputs, uint32_t timestamp)
+{
+    uint8_t changed = inputs ^ _lastInputs;
+    _lastInputs = inputs;
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        if (!(changed & (1 << i)))
         {
-            // I2C
-            I2Cdev::writeByte(_i2cAddress, CAP1188_SENSOR_INPUT_8_THRESHOLD_REG, threshold);
+            continue;
         }
-        break;
+        CAP1188Event event;
+        event.timestamp = timestamp;
+        event.type = (inputs & (1 << i)) ? CAP1188_EVENT_PRESS : CAP1188_EVENT_RELEASE;
+        event.input = i + 1;
+        // Event is dropped if nobody reads them
+        _events.push(event);
+    }
+}
+
+/*  Below is lock-free single producer/single consumer touch event queue */
+
+/**
+ * @brief Instantiates an empty touch event queue
+ */
+CAP1188EventQueue::CAP1188EventQueue() : _head(0), _tail(0){};
+
+/**
+ * @brief Adds an event to the queue. Must only be called by a single producer
+ * @param event event to add
+ * @return true on success, false if queue is full
+ */
+bool CAP1188EventQueue::push(const CAP1188Event &event)
+{
+    uint8_t head = _head;
+    if ((uint8_t)(head - _tail) >= CAP1188_EVENT_QUEUE_SIZE)
+    {
+        return false;
+    }
+    _events[head & (CAP1188_EVENT_QUEUE_SIZE - 1)] = event;
+    __sync_synchronize(); // Event must be stored before it is published to consumer
+    _head = head + 1;
+    return true;
+}
+
+/**
+ * @brief Takes the oldest event from the queue. Must only be called by a single consumer
+ * @param event buffer to receive event in to
+ * @return true on success, false if queue is empty
+ */
+bool CAP1188EventQueue::pop(CAP1188Event *event)
+{
+    uint8_t tail = _tail;
+    if (tail == _head)
+    {
+        return false;
+    }
+    __sync_synchronize(); // Event must be read after it was published by producer
+    *event = _events[tail & (CAP1188_EVENT_QUEUE_SIZE - 1)];
+    __sync_synchronize(); // Event must be read before its slot is released to producer
+    _tail = tail + 1;
+    return true;
+}
+
+/**
+ * @brief Returns amount of events in the queue
+ * @return amount of events
+ */
+uint8_t CAP1188EventQueue::available()
+{
+    return (uint8_t)(_head - _tail);
+}
+
+/**
+ * @brief Drops all events. Must not be called while producer or consumer are running
+ * @return void
+ */
+void CAP1188EventQueue::clear()
+{
+    _head = 0;
+    _tail = 0;
+}
+
+#if defined(CAP1188_ENABLE_STATS)
+/**
+ * @brief Returns bus statistics collected since the last resetStats()
+ * @return bus statistics
+ */
+const CAP1188Stats &CAP1188::getStats()
+{
+    return _stats;
+}
+
+/**
+ * @brief Resets bus statistics
+ * @return void
+ */
+void CAP1188::resetStats()
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+/**
+ * @brief Accounts an operation in bus statistics
+ * @param operation operation type (CAP1188_STATS_...)
+ * @param bytes amount of register bytes read or written
+ * @param success result of the operation
+ * @param latency duration of the operation in microseconds
+ * @return void
+ */
+void CAP1188::recordStats(uint8_t operation, uint8_t bytes, bool success, uint32_t latency)
+{
+    _stats.bytes += bytes;
+    if (!success)
+    {
+        _stats.errors++;
+    }
+    // Bucket N counts latencies below CAP1188_STATS_FIRST_BUCKET_US << N, the last one counts the rest
+    uint8_t bucket = 0;
+    while (bucket < CAP1188_STATS_BUCKETS - 1 && latency >= ((uint32_t)CAP1188_STATS_FIRST_BUCKET_US << bucket))
+    {
+        bucket++;
+    }
+    _stats.latency[operation][bucket]++;
+}
+#endif
+
+/**
+ * @brief Returns status of the last register access (after all retries), i.e. to find out why a getter returned 0
+ * @return CAP1188_STATUS_OK or CAP1188_STATUS_... error code
+ */
+CAP1188Status CAP1188::getLastStatus()
+{
+    return _lastStatus;
+}
+
+/**
+ * @brief Sets how failed register accesses are retried. Delay before retry N (starting from 0) is backoffUs << N,
+ * so a single glitch does not require re-initialisation of CAP1188
+ * @param retries amount of retries after a failed access (0 to disable retries)
+ * @param backoffUs delay before the first retry in microseconds
+ * @return void
+ */
+void CAP1188::setRetryPolicy(uint8_t retries, uint16_t backoffUs)
+{
+    _retries = retries;
+    _retryBackoffUs = backoffUs;
+}
+
+/*  Below is register access functionality shared by SPI and I2C interfaces */
+
+/**
+ * @brief Reads several consecutive registers using interface selected during initialisation
+ * @param startAddress first register address to read from
+ * @param buff buffer to receive register contents in to (must fit len bytes)
+ * @param len amount of registers to read
+ * @return CAP1188_STATUS_OK on success, CAP1188_STATUS_... error code otherwise
+ */
+CAP1188Status CAP1188_HOT_ATTR CAP1188::busReadRegisters(uint8_t startAddress, uint8_t* buff, uint8_t len)
+{
+    switch (_interface)
+    {
+#if !defined(CAP1188_DISABLE_SPI)
+    case CAP1188_INTERFACE_SPI:
+        readRegistersFromAddress(startAddress, buff, len);
+        return CAP1188_STATUS_OK;
+#endif
+
+#if !defined(CAP1188_DISABLE_I2C)
+    case CAP1188_INTERFACE_I2C:
+        return i2cReadRegisters(startAddress, buff, len);
+#endif
+
+    case CAP1188_INTERFACE_CUSTOM:
+        CAP1188_STATS(_stats.transactions++);
+        return _transport->readRegisters(startAddress, buff, len) ? CAP1188_STATUS_OK : CAP1188_STATUS_BUS_ERROR;
+
+    default:
+        return CAP1188_STATUS_NOT_INITIALISED;
+    }
+}
+
+/**
+ * @brief Writes several consecutive registers using interface selected during initialisation
+ * @param startAddress first register address to write to
+ * @param buff buffer with register contents to write (must contain len bytes)
+ * @param len amount of registers to write
+ * @return CAP1188_STATUS_OK on success, CAP1188_STATUS_... error code otherwise
+ */
+CAP1188Status CAP1188_HOT_ATTR CAP1188::busWriteRegisters(uint8_t startAddress, const uint8_t* buff, uint8_t len)
+{
+    switch (_interface)
+    {
+#if !defined(CAP1188_DISABLE_SPI)
+    case CAP1188_INTERFACE_SPI:
+        writeRegistersAtAddress(startAddress, buff, len);
+        return CAP1188_STATUS_OK;
+#endif
+
+#if !defined(CAP1188_DISABLE_I2C)
+    case CAP1188_INTERFACE_I2C:
+        return i2cWriteRegisters(startAddress, buff, len);
+#endif
+
+    case CAP1188_INTERFACE_CUSTOM:
+        CAP1188_STATS(_stats.transactions++);
+        return _transport->writeRegisters(startAddress, buff, len) ? CAP1188_STATUS_OK : CAP1188_STATUS_BUS_ERROR;
+
+    default:
+        return CAP1188_STATUS_NOT_INITIALISED;
+    }
+}
+
+/**
+ * @brief Reads several consecutive registers, then writes several other consecutive registers within a single bus transaction
+ * using interface selected during initialisation (user supplied transport is accessed twice)
+ * @param readAddress first register address to read from
+ * @param readBuff buffer to receive register contents in to (must fit readLen bytes)
+ * @param readLen amount of registers to read
+ * @param writeAddress first register address to write to
+ * @param writeBuff buffer with register contents to write (must contain writeLen bytes)
+ * @param writeLen amount of registers to write
+ * @return CAP1188_STATUS_OK on success, CAP1188_STATUS_... error code otherwise
+ */
+CAP1188Status CAP1188::busExchangeRegisters(uint8_t readAddress, uint8_t* readBuff, uint8_t readLen, uint8_t writeAddress, const uint8_t* writeBuff, uint8_t writeLen)
+{
+    switch (_interface)
+    {
+#if !defined(CAP1188_DISABLE_SPI)
+    case CAP1188_INTERFACE_SPI:
+        exchangeRegistersAtAddress(readAddress, readBuff, readLen, writeAddress, writeBuff, writeLen);
+        return CAP1188_STATUS_OK;
+#endif
+
+#if !defined(CAP1188_DISABLE_I2C)
+    case CAP1188_INTERFACE_I2C:
+    {
+        // Bus is not released after read, so write starts with a repeated start
+        CAP1188Status status = i2cReadRegisters(readAddress, readBuff, readLen, false);
+        return status != CAP1188_STATUS_OK ? status : i2cWriteRegisters(writeAddress, writeBuff, writeLen);
+    }
+#endif
+
+    case CAP1188_INTERFACE_CUSTOM:
+    {
+        CAP1188Status status = busReadRegisters(readAddress, readBuff, readLen);
+        return status != CAP1188_STATUS_OK ? status : busWriteRegisters(writeAddress, writeBuff, writeLen);
+    }
+
+    default:
+        return CAP1188_STATUS_NOT_INITIALISED;
+    }
+}
+
+/**
+ * @brief Sets user supplied bus lock, which is held during every bus transaction and for whole composed operations
+ * (i.e. read-modify-write). Has to be shared with all other drivers using the same bus
+ * NOTE: Lock has to be recursive, as composed operations take it again for every transaction
+ * @param lock function taking the lock (NULL to disable locking)
+ * @param unlock function releasing the lock
+ * @param arg user argument passed to lock/unlock functions
+ * @return void
+ */
+void CAP1188::setBusLock(CAP1188LockCallback lock, CAP1188LockCallback unlock, void *arg)
+{
+    _lock = lock;
+    _unlock = unlock;
+    _lockArg = arg;
+}
+
+#if defined(ESP32)
+/**
+ * @brief Sets FreeRTOS recursive mutex (created by xSemaphoreCreateRecursiveMutex()) used as bus lock (see setBusLock(...))
+ * @param mutex recursive mutex shared by all drivers using the same bus (NULL to disable locking)
+ * @return void
+ */
+void CAP1188::setBusMutex(SemaphoreHandle_t mutex)
+{
+    _busMutex = mutex;
+    _ownBusMutex = false; // User supplied mutex is never deleted
+}
+#endif
+
+/**
+ * @brief Takes bus lock (if any). Can be used to make a sequence of operations atomic, has to be followed by unlockBus()
+ * @return void
+ */
+void CAP1188_HOT_ATTR CAP1188::lockBus()
+{
+#if defined(ESP32)
+    if (_busMutex)
+    {
+        xSemaphoreTakeRecursive(_busMutex, portMAX_DELAY);
+        return;
+    }
+#endif
+    if (_lock)
+    {
+        _lock(_lockArg);
+    }
+}
+
+/**
+ * @brief Releases bus lock taken by lockBus()
+ * @return void
+ */
+void CAP1188_HOT_ATTR CAP1188::unlockBus()
+{
+#if defined(ESP32)
+    if (_busMutex)
+    {
+        xSemaphoreGiveRecursive(_busMutex);
+        return;
+    }
+#endif
+    if (_unlock)
+    {
+        _unlock(_lockArg);
+    }
+}
+
+/**
+ * @brief Decides if a failed register access is retried (according to _lastStatus) and waits before a retry
+ * @param attempt number of a failed attempt (starting from 0)
+ * @return true if access has to be retried, false otherwise
+ */
+bool CAP1188_HOT_ATTR CAP1188::retryAfter(uint8_t attempt)
+{
+    if (_lastStatus == CAP1188_STATUS_OK || _lastStatus == CAP1188_STATUS_NOT_INITIALISED || attempt >= _retries)
+    {
+        return false;
+    }
+#if !defined(CAP1188_DISABLE_SPI)
+    invalidateRegisterPointer(); // Not known where a failed transfer has left register pointer
+#endif
+    CAP1188_STATS(_stats.retries++);
+    delayMicroseconds((uint32_t)_retryBackoffUs << (attempt > 7 ? 7 : attempt));
+    return true;
+}
+
+/**
+ * @brief Reads a single register
+ * @param regAddress register address to read from
+ * @param data pointer to a buffer data to be read in
+ * @return true on success, false on error
+ */
+bool CAP1188_HOT_ATTR CAP1188::readRegister(uint8_t regAddress, uint8_t* data)
+{
+    return readRegisters(regAddress, data, 1);
+}
 
-    default:
-        // Unknown button number received
-        return false;
-        break;
-    }
-    // TODO: Return more appropriate error code
-    return true;
+/**
+ * @brief Writes a single register
+ * @param regAddress register address to write to
+ * @param data data to write into register
+ * @return true on success, false on error
+ */
+bool CAP1188_HOT_ATTR CAP1188::writeRegister(uint8_t regAddress, uint8_t data)
+{
+    return writeRegisters(regAddress, &data, 1);
 }
+
 /**
- * TODO: Function does not work as expected
- * @brief Writes data to all Sensor Input Threshold registers, which store the delta threshold that is used to determine if a touch has been detected
- * @param threshold threshold number (USE CAP1188_SENSOR_INPUT_THRESHOLD_...)
- * @return 0 on success
+ * @brief Modifies selected bits of a register (read-modify-write). Current register state is taken from
+ * shadow register file if it is known, so only a write is sent in such case
+ * @param regAddress register address to modify
+ * @param mask bits to modify
+ * @param value new value of the bits to modify
+ * @return true on success, false on error
  */
-bool CAP1188::setSensorInputThresholdAll(uint8_t threshold)
+bool CAP1188_HOT_ATTR CAP1188::modifyRegister(uint8_t regAddress, uint8_t mask, uint8_t value)
 {
+    CAP1188BusGuard guard(*this);
+    CAP1188_STATS(uint32_t startTime = micros());
     uint8_t reg;
-    // Allow write to all SENSOR INPUT THRESHOLD REGISTERS at the same time
-    // 1. Read RECALIBRATION CONFIGURATION REGISTER
-    // 2. Set B7 to 0
-    // 3. Write RECALIBRATION CONFIGURATION REGISTER back
-
-    if (!_i2c)
-    {
-        // SPI
-        readRegisterFromAddress(CAPP1188_RECALIBRATION_CONFIGURATION_REG, &reg);
-    }
-    else
+    bool success = getShadow(regAddress, &reg) || readRegister(regAddress, &reg);
+    if (success)
     {
-        // I2C
-        I2Cdev::readByte(_i2cAddress, CAPP1188_RECALIBRATION_CONFIGURATION_REG, &reg);
+        reg = (reg & ~mask) | (value & mask);
+        success = writeRegister(regAddress, reg);
     }
+    // Bus traffic itself is accounted by underlying read/write, so only latency and result are recorded
+    CAP1188_STATS(recordStats(CAP1188_STATS_RMW, 0, success, micros() - startTime));
+    return success;
+}
 
-    reg &= 0x7F;
-
-    if (!_i2c)
-    {
-        // SPI
-        writeRegisterAtAddress(CAPP1188_RECALIBRATION_CONFIGURATION_REG, reg);
-    }
-    else
+/**
+ * @brief Looks up position of a register within shadow register file
+ * @param regAddress register address
+ * @return index within shadow register file, -1 if register is not shadowed
+ */
+int8_t CAP1188_HOT_ATTR CAP1188::shadowIndex(uint8_t regAddress)
+{
+    uint8_t offset = 0;
+    for (uint8_t i = 0; i < sizeof(shadowRanges) / sizeof(shadowRanges[0]); i++)
     {
-        // I2C
-        I2Cdev::writeByte(_i2cAddress, CAPP1188_RECALIBRATION_CONFIGURATION_REG, reg);
+        if (regAddress >= shadowRanges[i].start && regAddress < shadowRanges[i].start + shadowRanges[i].len)
+        {
+            return offset + regAddress - shadowRanges[i].start;
+        }
+        offset += shadowRanges[i].len;
     }
+    return -1;
+}
 
-    // Setting input threshold value to 1st Input register which will modify all of them
-    if (!_i2c)
-    {
-        // SPI
-        writeRegisterAtAddress(CAP1188_SENSOR_INPUT_1_THRESHOLD_REG, threshold);
-    }
-    else
+/**
+ * @brief Reads a register state from shadow register file
+ * @param regAddress register address
+ * @param data pointer to a buffer data to be read in
+ * @return true if register state is known, false otherwise
+ */
+bool CAP1188_HOT_ATTR CAP1188::getShadow(uint8_t regAddress, uint8_t* data)
+{
+    int8_t index = shadowIndex(regAddress);
+    if (index < 0 || !(_shadowValid[index >> 3] & (1 << (index & 0x07))))
     {
-        // I2C
-        I2Cdev::writeByte(_i2cAddress, CAP1188_SENSOR_INPUT_1_THRESHOLD_REG, threshold);
+        return false;
     }
+    *data = _shadow[index];
+    return true;
+}
 
-    // Reset write to all SENSOR INPUT THRESHOLD REGISTERS at the same time (reset to default)
-    // 1. Read RECALIBRATION CONFIGURATION REGISTER
-    // 2. Set B7 to 1
-    // 3. Write RECALIBRATION CONFIGURATION REGISTER back
-    if (!_i2c)
+/**
+ * @brief Stores states of consecutive registers, which were read from or written to CAP1188, in shadow register file
+ * @param startAddress first register address
+ * @param data register contents
+ * @param len amount of registers
+ * @return void
+ */
+void CAP1188_HOT_ATTR CAP1188::updateShadow(uint8_t startAddress, const uint8_t* data, uint8_t len)
+{
+    for (uint8_t i = 0; i < len; i++)
     {
-        // SPI
-        readRegisterFromAddress(CAPP1188_RECALIBRATION_CONFIGURATION_REG, &reg);
+        uint8_t regAddress = startAddress + i;
+        int8_t index = shadowIndex(regAddress);
+        if (index < 0)
+        {
+            continue;
+        }
+        uint8_t reg = data[i];
+        if (regAddress == CAP1188_MAIN_CONTROL_REG)
+        {
+            // INT bit is set by CAP1188 itself, so it is never kept in shadow register file
+            reg &= ~CAP1188_MAIN_CONTROL_INT_BIT;
+        }
+        _shadow[index] = reg;
+        _shadowValid[index >> 3] |= 1 << (index & 0x07);
     }
-    else
+}
+
+/**
+ * @brief Writes consecutive shadowed registers, skipping the ones already holding desired contents according to shadow
+ * register file. Registers from the first to the last changed one are written within a single burst.
+ * NOTE: If the 1st Input threshold register is written, burst is extended up to 8th one, which may have been overwritten
+ * by BUT_LD_TH broadcast
+ * @param startAddress first register address to write to
+ * @param buff buffer with register contents to write (must contain len bytes)
+ * @param len amount of registers
+ * @return true on success (or if nothing had to be written), false on error
+ */
+bool CAP1188::writeChangedRegisters(uint8_t startAddress, const uint8_t* buff, uint8_t len)
+{
+    int16_t first = -1, last = -1;
+    for (uint8_t i = 0; i < len; i++)
     {
-        // I2C
-        I2Cdev::readByte(_i2cAddress, CAPP1188_RECALIBRATION_CONFIGURATION_REG, &reg);
+        uint8_t reg;
+        if (!getShadow(startAddress + i, &reg) || reg != buff[i])
+        {
+            if (first < 0)
+            {
+                first = i;
+            }
+            last = i;
+        }
     }
-
-    reg |= 0x80;
-
-    if (!_i2c)
+    if (first < 0)
     {
-        // SPI
-        writeRegisterAtAddress(CAPP1188_RECALIBRATION_CONFIGURATION_REG, reg);
+        return true;
     }
-    else
+    if (startAddress + first == CAP1188_SENSOR_INPUT_1_THRESHOLD_REG && startAddress + len > CAP1188_SENSOR_INPUT_8_THRESHOLD_REG)
     {
-        // I2C
-        I2Cdev::writeByte(_i2cAddress, CAPP1188_RECALIBRATION_CONFIGURATION_REG, reg);
+        last = CAP1188_SENSOR_INPUT_8_THRESHOLD_REG - startAddress;
     }
+    return writeRegisters(startAddress + first, buff + first, last - first + 1);
+}
 
-    return 0;
+/**
+ * @brief Marks all registers in shadow register file as unknown
+ * @return void
+ */
+void CAP1188::invalidateShadow()
+{
+    memset(_shadowValid, 0, sizeof(_shadowValid));
 }
 
+#if CAP1188_HAS_FEATURE(CAP1188_FEATURE_COUNTS)
 /**
- * @brief Reads data from Sensor Input Threshold registers, which store the delta threshold that is used to determine if a touch has been detected
- * @param buttonNumber number of a button netween 1...8
- * @return register content with selected button number threshold, 0 on error
+ * @brief Reads Sensor Input Delta Count registers of all sensor inputs at once. Delta count is a difference between
+ * the last measurement and the base count (in two's complement, capped at 127 and -128)
+ * @param deltaCounts buffer to receive delta counts of sensor inputs 1...8 in to
+ * @return true on success, false on error
  */
-uint8_t CAP1188::getSensorInputThreshold(uint8_t buttonNumber)
+bool CAP1188::getDeltaCounts(int8_t deltaCounts[8])
 {
-    uint8_t reg;
-    switch (buttonNumber)
-    {
-    case 1:
-        if (!_i2c)
-        {
-            // SPI
-            readRegisterFromAddress(CAP1188_SENSOR_INPUT_1_THRESHOLD_REG, &reg);
-        }
-        else
-        {
-            // I2C
-            I2Cdev::readByte(_i2cAddress, CAP1188_SENSOR_INPUT_1_THRESHOLD_REG, &reg);
-        }
-        break;
+    return readRegisters(CAP1188_SENSOR_INPUT_1_DELTA_COUNT_REG, (uint8_t*)deltaCounts, 8);
+}
 
-    case 2:
-        if (!_i2c)
-        {
-            // SPI
-            readRegisterFromAddress(CAP1188_SENSOR_INPUT_2_THRESHOLD_REG, &reg);
-        }
-        else
-        {
-            // I2C
-            I2Cdev::readByte(_i2cAddress, CAP1188_SENSOR_INPUT_2_THRESHOLD_REG, &reg);
-        }
-        break;
+/**
+ * @brief Reads Sensor Input Base Count registers of all sensor inputs at once. Base count is a reference value,
+ * which is used to calculate delta count
+ * @param baseCounts buffer to receive base counts of sensor inputs 1...8 in to
+ * @return true on success, false on error
+ */
+bool CAP1188::getBaseCounts(uint8_t baseCounts[8])
+{
+    return readRegisters(CAP1188_SENSOR_INPUT_1_BASE_COUNT_REG, baseCounts, 8);
+}
+#endif
 
-    case 3:
-        if (!_i2c)
-        {
-            // SPI
-            readRegisterFromAddress(CAP1188_SENSOR_INPUT_3_THRESHOLD_REG, &reg);
-        }
-        else
-        {
-            // I2C
-            I2Cdev::readByte(_i2cAddress, CAP1188_SENSOR_INPUT_3_THRESHOLD_REG, &reg);
-        }
-        break;
+#if !defined(CAP1188_DISABLE_I2C)
+/*  Below is minimal I2C functionality set required to communicate with CAP1188 via I2C */
 
-    case 4:
-        if (!_i2c)
-        {
-            // SPI
-            readRegisterFromAddress(CAP1188_SENSOR_INPUT_4_THRESHOLD_REG, &reg);
-        }
-        else
-        {
-            // I2C
-            I2Cdev::readByte(_i2cAddress, CAP1188_SENSOR_INPUT_4_THRESHOLD_REG, &reg);
-        }
-        break;
+/**
+ * @brief Sets I2C clock frequency of the bus CAP1188 is connected to. NOTE: Clock is shared by all devices on the same I2C bus
+ * @param clock I2C clock frequency in Hz (i.e. 100000, 400000)
+ * @return void
+ */
+void CAP1188::setI2CClock(uint32_t clock)
+{
+    _wire->setClock(clock);
+}
 
-    case 5:
-        if (!_i2c)
-        {
-            // SPI
-            readRegisterFromAddress(CAP1188_SENSOR_INPUT_5_THRESHOLD_REG, &reg);
-        }
-        else
+/**
+ * @brief Reads several consecutive registers via I2C: register address is written, followed by a repeated start and
+ * a sequential read (CAP1188 increments register address after every byte). Up to CAP1188_I2C_BUFFER_LENGTH registers are read per transaction
+ * @param regAddress first register address to read from
+ * @param data pointer to a buffer data to be read in (must fit len bytes)
+ * @param len amount of registers to read
+ * @param sendStop false to keep the bus after the last read (next transaction starts with a repeated start)
+ * @return CAP1188_STATUS_OK on success, CAP1188_STATUS_... error code otherwise
+ */
+CAP1188Status CAP1188_HOT_ATTR CAP1188::i2cReadRegisters(uint8_t regAddress, uint8_t* data, uint8_t len, bool sendStop)
+{
+    while (len)
+    {
+        uint8_t chunk = len > CAP1188_I2C_BUFFER_LENGTH ? CAP1188_I2C_BUFFER_LENGTH : len;
+        CAP1188_STATS(_stats.transactions++);
+        _wire->beginTransmission((uint8_t)_i2cAddress);
+        _wire->write(regAddress);
+        uint8_t result = _wire->endTransmission(false); // Bus is not released, so read starts with a repeated start
+        if (result != 0)
         {
-            // I2C
-            I2Cdev::readByte(_i2cAddress, CAP1188_SENSOR_INPUT_5_THRESHOLD_REG, &reg);
+            return i2cStatus(result);
         }
-        break;
-
-    case 6:
-        if (!_i2c)
+        if (_wire->requestFrom((uint8_t)_i2cAddress, chunk, (uint8_t)(sendStop || chunk < len)) != chunk)
         {
-            // SPI
-            readRegisterFromAddress(CAP1188_SENSOR_INPUT_6_THRESHOLD_REG, &reg);
+            // Drop whatever was received, so it is not read by the next transaction
+            while (_wire->available())
+            {
+                _wire->read();
+            }
+            return CAP1188_STATUS_SHORT_READ;
         }
-        else
+        for (uint8_t i = 0; i < chunk; i++)
         {
-            // I2C
-            I2Cdev::readByte(_i2cAddress, CAP1188_SENSOR_INPUT_6_THRESHOLD_REG, &reg);
+            data[i] = _wire->read();
         }
-        break;
+        regAddress += chunk;
+        data += chunk;
+        len -= chunk;
+    }
+    return CAP1188_STATUS_OK;
+}
 
-    case 7:
-        if (!_i2c)
-        {
-            // SPI
-            readRegisterFromAddress(CAP1188_SENSOR_INPUT_7_THRESHOLD_REG, &reg);
-        }
-        else
+/**
+ * @brief Writes several consecutive registers via I2C within a single transaction (CAP1188 increments register address after every byte).
+ * Up to CAP1188_I2C_BUFFER_LENGTH - 1 registers are written per transaction, as register address takes one byte of Wire buffer
+ * @param regAddress first register address to write to
+ * @param data pointer to a buffer with data to write (must contain len bytes)
+ * @param len amount of registers to write
+ * @return CAP1188_STATUS_OK on success, CAP1188_STATUS_... error code otherwise
+ */
+CAP1188Status CAP1188_HOT_ATTR CAP1188::i2cWriteRegisters(uint8_t regAddress, const uint8_t* data, uint8_t len)
+{
+    while (len)
+    {
+        uint8_t chunk = len > CAP1188_I2C_BUFFER_LENGTH - 1 ? CAP1188_I2C_BUFFER_LENGTH - 1 : len;
+        CAP1188_STATS(_stats.transactions++);
+        _wire->beginTransmission((uint8_t)_i2cAddress);
+        _wire->write(regAddress);
+        _wire->write(data, chunk);
+        uint8_t result = _wire->endTransmission();
+        if (result != 0)
         {
-            // I2C
-            I2Cdev::readByte(_i2cAddress, CAP1188_SENSOR_INPUT_7_THRESHOLD_REG, &reg);
+            return i2cStatus(result);
         }
-        break;
+        regAddress += chunk;
+        data += chunk;
+        len -= chunk;
+    }
+    return CAP1188_STATUS_OK;
+}
+/**
+ * @brief Translates result of _wire->endTransmission(...) into a status code
+ * @param result result of _wire->endTransmission(...)
+ * @return CAP1188_STATUS_... code
+ */
+CAP1188Status CAP1188_HOT_ATTR CAP1188::i2cStatus(uint8_t result)
+{
+    switch (result)
+    {
+    case 0:
+        return CAP1188_STATUS_OK;
 
-    case 8:
-        if (!_i2c)
-        {
-            // SPI
-            readRegisterFromAddress(CAP1188_SENSOR_INPUT_8_THRESHOLD_REG, &reg);
-        }
-        else
-        {
-            // I2C
-            I2Cdev::readByte(_i2cAddress, CAP1188_SENSOR_INPUT_8_THRESHOLD_REG, &reg);
-        }
-        break;
+    case 2: // Address NACK
+    case 3: // Data NACK
+        return CAP1188_STATUS_NACK;
 
     default:
-        // Unknown button received
-        return 0;
-        break;
+        return CAP1188_STATUS_BUS_ERROR;
     }
-
-    return reg;
 }
+#endif
 
+#if !defined(CAP1188_DISABLE_SPI)
 /*  Below is minimal SPI functionality set required to communicate with CAP1188 via SPI */
 
+/**
+ * @brief Sets SPI clock frequency used to communicate with CAP1188
+ * @param clock SPI clock frequency in Hz (default is CAP1188_SPI_DEFAULT_CLOCK)
+ * @return void
+ */
+void CAP1188::setSPIClock(uint32_t clock)
+{
+    _spiClock = clock;
+}
+
 /**
  * @brief Sends a command to reset SPI interface on CAP1188
  * @return true
  */
-bool CAP1188::resetSPI()
+bool CAP1188_COLD_ATTR CAP1188::resetSPI()
 {
     // When 0x7A is sent twice, SPI communication interface is reset on CAP1188
     uint8_t buff[2] = {0x7A, 0x7A};
-    digitalWrite(_csPin, LOW); // Asserting CS pin low to begin communication
-    SPI.transferBytes(buff, NULL, 2);
-    digitalWrite(_csPin, HIGH); // Asserting CS pin high to end communication
+    lockBus();
+    spiTransfer(buff, 2);
+    unlockBus();
+    invalidateRegisterPointer();
     return true;
 }
 
 /**
- * @brief Sends a command via SPI to set register pointer for CAP1188
- * @param regAddress regiuster address in hex
+ * @brief Sends commands via SPI to CAP1188 within a single CS frame to: (1) set a register pointer (2) write data to a pointed register.
+ * NOTE: Register pointer is only set if it does not already point to a desired register
+ * @param regAddress register address to write to
+ * @param data data to write into regiser
  * @return true
  */
-bool CAP1188::setRegisterAddress(uint8_t regAddress)
+bool CAP1188_HOT_ATTR CAP1188::writeRegisterAtAddress(uint8_t regAddress, uint8_t data)
 {
-    // When 0x7D followed by REGISTER ADDRESS is sent,
-    // register pointer on CAP1188 is set to a desired
-    // REGISTER ADDRESS to read/write data from/to
-    uint8_t buff[2] = {0x7D, regAddress};
-    digitalWrite(_csPin, LOW); // Asserting CS pin low to begin communication
-    SPI.transferBytes(buff, NULL, 2);
-    digitalWrite(_csPin, HIGH); // Asserting CS pin high to end communication
+    writeRegistersAtAddress(regAddress, &data, 1);
     return true;
 }
 
 /**
- * @brief Sends a command via SPI to read register currently pointed by register pointer from CAP1188.
- * NOTE: Register pointer needs to be set before calling this function to read data from a desired register
- * @return Register data
+ * @brief Sends commands via SPI to CAP1188 to write several consecutive registers, making use of register pointer auto-increment.
+ * Up to CAP1188_MAX_BURST_LENGTH registers are written within a single CS frame
+ * @param regAddress first register address to write to
+ * @param data pointer to a buffer with data to write (must contain len bytes)
+ * @param len amount of registers to write
+ * @return void
+ */
+void CAP1188_HOT_ATTR CAP1188::writeRegistersAtAddress(uint8_t regAddress, const uint8_t* data, uint8_t len)
+{
+    uint8_t buff[2 * CAP1188_MAX_BURST_LENGTH + 2];
+    while (len)
+    {
+        uint8_t chunk = len > CAP1188_MAX_BURST_LENGTH ? CAP1188_MAX_BURST_LENGTH : len;
+        uint8_t buffLen = 0;
+        if (_regPointer != regAddress)
+        {
+            // When 0x7D followed by REGISTER ADDRESS is sent,
+            // register pointer on CAP1188 is set to a desired
+            // REGISTER ADDRESS to read/write data from/to
+            buff[buffLen++] = 0x7D;
+            buff[buffLen++] = regAddress;
+        }
+        // When 0x7E followed by DATA is sent,
+        // data is written to a register, pointed
+        // by a register pointer by CAP1188 and register pointer is incremented
+        for (uint8_t i = 0; i < chunk; i++)
+        {
+            buff[buffLen++] = 0x7E;
+            buff[buffLen++] = data[i];
+        }
+        spiTransfer(buff, buffLen);
+
+        _regPointer = regAddress;
+        advanceRegisterPointer(chunk);
+        regAddress += chunk;
+        data += chunk;
+        len -= chunk;
+    }
+}
+
+/**
+ * @brief Sends commands via SPI to CAP1188 to read several consecutive registers and then write several other consecutive
+ * registers within a single CS frame. Data of the last read register is clocked out by the commands of the write,
+ * so no dummy byte is needed
+ * @param readAddress first register address to read from
+ * @param readData pointer to a buffer data to be read in (must fit readLen bytes)
+ * @param readLen amount of registers to read (up to CAP1188_MAX_BURST_LENGTH)
+ * @param writeAddress first register address to write to
+ * @param writeData pointer to a buffer with data to write (must contain writeLen bytes)
+ * @param writeLen amount of registers to write (1...CAP1188_MAX_BURST_LENGTH)
+ * @return void
+ */
+void CAP1188::exchangeRegistersAtAddress(uint8_t readAddress, uint8_t* readData, uint8_t readLen, uint8_t writeAddress, const uint8_t* writeData, uint8_t writeLen)
+{
+    uint8_t buff[3 * CAP1188_MAX_BURST_LENGTH + 4];
+    uint8_t buffLen = 0;
+    if (_regPointer != readAddress)
+    {
+        buff[buffLen++] = 0x7D;
+        buff[buffLen++] = readAddress;
+    }
+    uint8_t dataStart = buffLen + 1;
+    for (uint8_t i = 0; i < readLen; i++)
+    {
+        buff[buffLen++] = 0x7F;
+    }
+    _regPointer = readAddress;
+    advanceRegisterPointer(readLen);
+    if (_regPointer != writeAddress)
+    {
+        buff[buffLen++] = 0x7D;
+        buff[buffLen++] = writeAddress;
+    }
+    for (uint8_t i = 0; i < writeLen; i++)
+    {
+        buff[buffLen++] = 0x7E;
+        buff[buffLen++] = writeData[i];
+    }
+    spiTransfer(buff, buffLen);
+    memcpy(readData, &buff[dataStart], readLen);
+
+    _regPointer = writeAddress;
+    advanceRegisterPointer(writeLen);
+}
+
+/**
+ * @brief Sends commands via SPI to CAP1188 within a single CS frame to: (1) set a register pointer (2) read data from a register, pointed by register pointer
+ * NOTE: Register pointer is only set if it does not already point to a desired register
+ * @param regAddress register address to read from
+ * @param data pointer to a buffer data to be read in
+ * @return void
+ */
+void CAP1188_HOT_ATTR CAP1188::readRegisterFromAddress(uint8_t regAddress, uint8_t* data)
+{
+    readRegistersFromAddress(regAddress, data, 1);
+}
+
+/**
+ * @brief Sends commands via SPI to CAP1188 to read several consecutive registers, making use of register pointer auto-increment.
+ * Up to CAP1188_MAX_BURST_LENGTH registers are read within a single CS frame
+ * @param regAddress first register address to read from
+ * @param data pointer to a buffer data to be read in (must fit len bytes)
+ * @param len amount of registers to read
+ * @return void
+ */
+void CAP1188_HOT_ATTR CAP1188::readRegistersFromAddress(uint8_t regAddress, uint8_t* data, uint8_t len)
+{
+    uint8_t buff[CAP1188_MAX_BURST_LENGTH + 3];
+    while (len)
+    {
+        uint8_t chunk = len > CAP1188_MAX_BURST_LENGTH ? CAP1188_MAX_BURST_LENGTH : len;
+        uint8_t buffLen = 0;
+        if (_regPointer != regAddress)
+        {
+            buff[buffLen++] = 0x7D;
+            buff[buffLen++] = regAddress;
+        }
+        // When 0x7F is sent, CAP1188 sends data from
+        // a register, pointed by register pointer by CAP1188
+        // during the next byte and increments register pointer.
+        // Last byte is a dummy byte (not a command) to clock out the last register
+        uint8_t dataStart = buffLen + 1;
+        for (uint8_t i = 0; i < chunk; i++)
+        {
+            buff[buffLen++] = 0x7F;
+        }
+        buff[buffLen++] = 0xFF;
+        spiTransfer(buff, buffLen);
+        memcpy(data, &buff[dataStart], chunk);
+
+        _regPointer = regAddress;
+        advanceRegisterPointer(chunk);
+        regAddress += chunk;
+        data += chunk;
+        len -= chunk;
+    }
+}
+
+/**
+ * @brief Transfers a buffer via SPI within a single CS frame. Received bytes overwrite the buffer
+ * @param buff buffer with bytes to send, receives bytes read back
+ * @param len amount of bytes to transfer
+ * @return void
  */
-uint8_t CAP1188::readRegister()
+void CAP1188_HOT_ATTR CAP1188::spiTransfer(uint8_t* buff, uint8_t len)
 {
-    // When 0x7F is sent, CAP1188 sends data from
-    // a register, pointed by register pointer by CAP1188
-    uint8_t buff = 0x7F;
+    CAP1188_STATS(_stats.transactions++);
+    if (_spi3Wire)
+    {
+        spi3WireTransfer(buff, len);
+        return;
+    }
+    _spi->beginTransaction(SPISettings(_spiClock, MSBFIRST, SPI_MODE0));
     digitalWrite(_csPin, LOW); // Asserting CS pin low to begin communication
-    SPI.transferBytes(&buff, NULL, 1);
-    SPI.transferBytes(NULL, &buff, 1); // Reusing variable to store contents of a read register
-    digitalWrite(_csPin, HIGH);        // Asserting CS pin high to end communication
-    return buff;
+    _spi->transferBytes(buff, buff, len);
+    digitalWrite(_csPin, HIGH); // Asserting CS pin high to end communication
+    _spi->endTransaction();
 }
 
 /**
- * @brief Sends a command via SPI to write data to a register currently pointed by register pointer from CAP1188.
- * NOTE: Register pointer needs to be set before calling this function to write data to a desired register
- * @return true
+ * @brief Transfers a 4-wire mode frame via SPI 3-wire interface within a single CS frame. In 3-wire mode CAP1188 drives
+ * data line during the byte following 0x7F command, while in 4-wire mode it sends data in parallel with the next command.
+ * So commands are sent one by one and data read after each 0x7F is stored in place of the following byte, which results
+ * in the same buffer contents as in case of 4-wire transfer. Dummy bytes (only required to clock data out in 4-wire mode) are not sent
+ * @param buff buffer with 4-wire mode frame to send, receives bytes read back
+ * @param len amount of bytes in a frame
+ * @return void
  */
-bool CAP1188::writeRegister(uint8_t data)
+void CAP1188::spi3WireTransfer(uint8_t* buff, uint8_t len)
 {
-    // When 0x7E followed by DATA is sent,
-    // data is written to a register, pointed
-    // by a register pointer by CAP1188
-    uint8_t buff[2] = {0x7E, data};
+    // Rounded up (so at least 1us), clock never exceeds the one set by setSPIClock(...)
+    uint32_t halfPeriodUs = (500000 + _spiClock - 1) / _spiClock;
+    uint8_t command = len ? buff[0] : 0xFF;
     digitalWrite(_csPin, LOW); // Asserting CS pin low to begin communication
-    SPI.transferBytes(buff, NULL, 2);
+    for (uint8_t i = 0; i < len; i++)
+    {
+        uint8_t next = i + 1 < len ? buff[i + 1] : 0xFF;
+        switch (command)
+        {
+        case 0x7D: // Set register pointer
+        case 0x7E: // Write data
+            // Command is followed by an operand (register address or data)
+            spi3WireWrite(command, halfPeriodUs);
+            if (i + 1 < len)
+            {
+                spi3WireWrite(next, halfPeriodUs);
+                i++;
+                next = i + 1 < len ? buff[i + 1] : 0xFF;
+            }
+            break;
+
+        case 0x7F: // Read data
+            spi3WireWrite(command, halfPeriodUs);
+            if (i + 1 < len)
+            {
+                buff[i + 1] = spi3WireRead(halfPeriodUs);
+            }
+            break;
+
+        case 0x7A: // Reset SPI interface
+            spi3WireWrite(command, halfPeriodUs);
+            break;
+
+        default:
+            // Dummy byte
+            break;
+        }
+        command = next;
+    }
     digitalWrite(_csPin, HIGH); // Asserting CS pin high to end communication
-    return true;
+    if (_sdioOutput)
+    {
+        pinMode(_sdioPin, INPUT); // Release data line
+        _sdioOutput = false;
+    }
 }
 
 /**
- * @brief Sends commands via SPI to CAP1188 to: (1) set a register pointer (2) write data to a pointed register
- * @param regAddress register address to write to
- * @param data data to write into regiser
- * @return true
+ * @brief Clocks a byte out via SPI 3-wire interface (MSB first, SPI mode 0)
+ * @param data byte to send
+ * @param halfPeriodUs half of SCK period in microseconds
+ * @return void
  */
-bool CAP1188::writeRegisterAtAddress(uint8_t regAddress, uint8_t data)
+void CAP1188::spi3WireWrite(uint8_t data, uint32_t halfPeriodUs)
 {
-    setRegisterAddress(regAddress);
-    writeRegister(data);
-    return true;
+    // Direction is only switched when a command follows data read, not for every byte
+    if (!_sdioOutput)
+    {
+        pinMode(_sdioPin, OUTPUT);
+        _sdioOutput = true;
+    }
+    for (uint8_t mask = 0x80; mask; mask >>= 1)
+    {
+        digitalWrite(_sdioPin, (data & mask) ? HIGH : LOW);
+        delayMicroseconds(halfPeriodUs);
+        digitalWrite(_sckPin, HIGH); // CAP1188 samples data on rising edge
+        delayMicroseconds(halfPeriodUs);
+        digitalWrite(_sckPin, LOW);
+    }
 }
 
 /**
- * @brief Sends commands via SPI to CAP1188 to: (1) set a register pointer (2) read data from a register, pointed by register pointer
- * @param regAddress register address to read from
- * @param data pointer to a buffer data to be read in
+ * @brief Clocks a byte in via SPI 3-wire interface (MSB first, SPI mode 0)
+ * @param halfPeriodUs half of SCK period in microseconds
+ * @return received byte
+ */
+uint8_t CAP1188::spi3WireRead(uint32_t halfPeriodUs)
+{
+    uint8_t data = 0;
+    if (_sdioOutput)
+    {
+        pinMode(_sdioPin, INPUT); // CAP1188 drives data line after falling edge of the last command bit
+        _sdioOutput = false;
+    }
+    for (uint8_t mask = 0x80; mask; mask >>= 1)
+    {
+        delayMicroseconds(halfPeriodUs);
+        digitalWrite(_sckPin, HIGH);
+        if (digitalRead(_sdioPin))
+        {
+            data |= mask;
+        }
+        delayMicroseconds(halfPeriodUs);
+        digitalWrite(_sckPin, LOW);
+    }
+    return data;
+}
+
+/**
+ * @brief Marks register pointer of CAP1188 as unknown, so next SPI access sets it explicitly.
+ * Must be called whenever register pointer might have changed without driver knowing it (reset, SPI interface reset, errors)
+ * @return void
+ */
+void CAP1188_HOT_ATTR CAP1188::invalidateRegisterPointer()
+{
+    _regPointer = CAP1188_REG_POINTER_UNKNOWN;
+}
+
+/**
+ * @brief Keeps track of register pointer of CAP1188, which is automatically incremented after every read or write
+ * @param count amount of registers read or written
  * @return void
  */
-void CAP1188::readRegisterFromAddress(uint8_t regAddress, uint8_t* data)
+void CAP1188_HOT_ATTR CAP1188::advanceRegisterPointer(uint8_t count)
 {
-    setRegisterAddress(regAddress);
-    *data = readRegister();
-}
\ No newline at end of file
+    if (_regPointer == CAP1188_REG_POINTER_UNKNOWN)
+    {
+        return;
+    }
+    _regPointer += count;
+    if (_regPointer > 0xFF)
+    {
+        // Behaviour of register pointer beyond last register is not documented
+        invalidateRegisterPointer();
+    }
+}
+#endif
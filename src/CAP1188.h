@@ -1,3 +1,8 @@
+#ifndef _CAP1188_H_
+#define _CAP1188_H_
+
+#include <Arduino.h>
+
 // Selects CAP1188 Address. Use resistors, connected to PIN 14 in pull-down mode (pin 14 -> GND) to adjut its address:
 //  1. GND:                 SPI Communications using Normal 4-wire Protocol
 //  2. 56k to GND:          SPI Communications using BiDirectional 3-wire Protocol
@@ -43,6 +48,16 @@
 #define CAP1188_CYCLE_TIME_105ms                         0x02
 #define CAP1188_CYCLE_TIME_140ms                         0x03
 
+// Used for SENSITIVITY CONTROL REGISTER (0x1F), B6-B4 and STANDBY SENSITIVITY REGISTER (0x42), B2-B0. Multiplier of measured capacitance change (128x is the most sensitive)
+#define CAP1188_SENSITIVITY_128X                         0x00
+#define CAP1188_SENSITIVITY_64X                          0x01
+#define CAP1188_SENSITIVITY_32X                          0x02
+#define CAP1188_SENSITIVITY_16X                          0x03
+#define CAP1188_SENSITIVITY_8X                           0x04
+#define CAP1188_SENSITIVITY_4X                           0x05
+#define CAP1188_SENSITIVITY_2X                           0x06
+#define CAP1188_SENSITIVITY_1X                           0x07
+
 // Used for SENSOR INPUT THRESHOLD REGISTERS(0x30-0x37)
 #define CAP1188_SENSOR_INPUT_THRESHOLD_1                 0x01
 #define CAP1188_SENSOR_INPUT_THRESHOLD_2                 0x02
@@ -52,34 +67,520 @@
 #define CAP1188_SENSOR_INPUT_THRESHOLD_32                0x20
 #define CAP1188_SENSOR_INPUT_THRESHOLD_64                0x40
 
+// Used for MULTIPLE TOUCH PATTERN CONFIGURATION REGISTER (0x2B), B3-B2. Delta count (in % of input threshold), at which input is counted for a pattern
+#define CAP1188_MTP_THRESHOLD_12_5_PERCENT               0x00
+#define CAP1188_MTP_THRESHOLD_25_PERCENT                 0x01
+#define CAP1188_MTP_THRESHOLD_37_5_PERCENT               0x02
+#define CAP1188_MTP_THRESHOLD_100_PERCENT                0x03
+
+// Used for MULTIPLE TOUCH PATTERN CONFIGURATION REGISTER (0x2B), B1
+#define CAP1188_MTP_MODE_COUNT                           0x00 // Pattern is detected if at least as many inputs as bits set in pattern are touched
+#define CAP1188_MTP_MODE_PATTERN                         0x01 // Pattern is detected if all inputs of pattern are touched
+
+// Register images packed from the options above, i.e. to fill in CAP1188Config at compile time
+#define CAP1188_MULTIPLE_TOUCH_CONFIG(enable, touches)   ((enable) ? (0x80 | ((((touches) - 1) & 0x03) << 2)) : 0x00)
+#define CAP1188_STANDBY_CONFIG(averageSum, samplesPerMeasurement, samplingTime, cycleTime) \
+    (((averageSum) << 7) | ((samplesPerMeasurement) << 4) | ((samplingTime) << 2) | (cycleTime))
+#define CAP1188_AVERAGING_AND_SAMPLING_CONFIG(samplesPerMeasurement, samplingTime, cycleTime) \
+    (((samplesPerMeasurement) << 4) | ((samplingTime) << 2) | (cycleTime))
+
+// Used for LED BEHAVIOR REGISTERS (0x81-0x82), 2 bits per LED
+#define CAP1188_LED_BEHAVIOR_DIRECT                      0x00
+#define CAP1188_LED_BEHAVIOR_PULSE_1                     0x01
+#define CAP1188_LED_BEHAVIOR_PULSE_2                     0x02
+#define CAP1188_LED_BEHAVIOR_BREATHE                     0x03
+
+// Used for LED PULSE 1 PERIOD REGISTER (0x84), B7. Pulse 1 starts when input is touched (default) or released
+#define CAP1188_LED_PULSE_1_ON_TOUCH                     0x00
+#define CAP1188_LED_PULSE_1_ON_RELEASE                   0x80
+
+// Register images of LED engine, i.e. to fill in CAP1188LedConfig at compile time.
+// Periods are rounded down to 32ms steps (32...4064ms), duty cycles and ramp/off delay settings are 4-bit/3-bit codes from datasheet
+#define CAP1188_LED_BEHAVIORS(led1, led2, led3, led4)    (((led4) << 6) | ((led3) << 4) | ((led2) << 2) | (led1))
+#define CAP1188_LED_PERIOD(periodMs)                     (((periodMs) / 32) & 0x7F)
+#define CAP1188_LED_PULSE_COUNTS(pulse1, pulse2)         (((((pulse2) - 1) & 0x07) << 3) | (((pulse1) - 1) & 0x07))
+#define CAP1188_LED_DUTY_CYCLE(minDuty, maxDuty)         ((((maxDuty) & 0x0F) << 4) | ((minDuty) & 0x0F))
+#define CAP1188_LED_RAMP_RATES(rise, fall)               ((((rise) & 0x07) << 3) | ((fall) & 0x07))
+#define CAP1188_LED_OFF_DELAYS(breathe, direct)          ((((breathe) & 0x07) << 4) | ((direct) & 0x07))
+
+// Default SPI clock frequency used to communicate with CAP1188 (can be changed by setSPIClock(...))
+#define CAP1188_SPI_DEFAULT_CLOCK                        1000000
+
+// Interfaces used to communicate with CAP1188. Only required interfaces can be compiled in by defining
+// CAP1188_DISABLE_I2C or CAP1188_DISABLE_SPI (i.e. via build flags), so unused code and libraries are not linked.
+// User supplied transport (see CAP1188Transport) is always available
+#define CAP1188_INTERFACE_NONE                           0x00
+#define CAP1188_INTERFACE_I2C                            0x01
+#define CAP1188_INTERFACE_SPI                            0x02
+#define CAP1188_INTERFACE_CUSTOM                         0x03
+
+// Optional features. All of them are compiled in by default; define CAP1188_FEATURES (i.e. via build flags) as a combination of
+// CAP1188_FEATURE_... to only compile required ones, i.e. -DCAP1188_FEATURES=CAP1188_FEATURE_THRESHOLDS on small flash parts.
+// Initialisation, sensor inputs, interrupt driven mode, configuration profiles and register access are always available
+#define CAP1188_FEATURE_LED                              0x01 // LED linking, LED engine and direct LED control
+#define CAP1188_FEATURE_THRESHOLDS                       0x02 // Thresholds, sensitivity, averaging and sampling, multiple touch (pattern) configuration
+#define CAP1188_FEATURE_STANDBY                          0x04 // Standby configuration, channels, sensitivity, threshold and power states
+#define CAP1188_FEATURE_COUNTS                           0x08 // Delta counts, base counts, calibration and its snapshots
+#define CAP1188_FEATURE_ALL                              0x0F
+#if !defined(CAP1188_FEATURES)
+#define CAP1188_FEATURES                                 CAP1188_FEATURE_ALL
+#endif
+#define CAP1188_HAS_FEATURE(feature)                     ((CAP1188_FEATURES & (feature)) != 0)
+
+// Status codes of register accesses (see getLastStatus())
+#define CAP1188_STATUS_OK                                0x00
+#define CAP1188_STATUS_NOT_INITIALISED                   0x01
+#define CAP1188_STATUS_NACK                              0x02 // I2C address or data was not acknowledged
+#define CAP1188_STATUS_SHORT_READ                        0x03 // Less bytes than requested were received
+#define CAP1188_STATUS_BUS_ERROR                         0x04 // Other bus or user transport error
+
+// Default retry policy of failed register accesses (see setRetryPolicy(...))
+#define CAP1188_DEFAULT_RETRIES                          2
+#define CAP1188_DEFAULT_RETRY_BACKOFF_US                 100
+
+// Used as resetPin if RESET pin of CAP1188 is not connected
+#define CAP1188_NO_RESET_PIN                             0xFF
+
+// Initialisation modes of init...(...) functions. CAP1188_INIT_WARM and CAP1188_INIT_NO_WAIT can be combined
+#define CAP1188_INIT_COLD                                0x00 // Reset CAP1188 and apply configuration, wait until done
+#define CAP1188_INIT_WARM                                0x01 // Skip reset and configuration if CAP1188 is already configured
+#define CAP1188_INIT_NO_WAIT                             0x02 // Return during reset, poll isReady() to finish initialisation
+
+// Duration of reset pulse on RESET pin
+#define CAP1188_RESET_PULSE_MS                           10
+
+// Initialisation states
+#define CAP1188_INIT_STATE_NONE                          0x00
+#define CAP1188_INIT_STATE_RESET                         0x01
+#define CAP1188_INIT_STATE_READY                         0x02
+
+// Expected contents of PRODUCT ID (0xFD) and MANUFACTURER ID (0xFE) registers
+#define CAP1188_PRODUCT_ID                               0x50
+#define CAP1188_MANUFACTURER_ID                          0x5D
+
+// Register contents written during initialisation, used as configuration fingerprint by CAP1188_INIT_WARM
+#define CAP1188_INIT_MULTIPLE_TOUCH_CONFIG               0x00 // Multiple touch circuitry disabled
+#define CAP1188_INIT_LED_LINKING                         0xFF // All LEDs linked to buttons
+
+// Maximum amount of registers read or written within a single SPI transaction. Longer accesses are split into several transactions
+#define CAP1188_MAX_BURST_LENGTH                         32
+
+// Maximum amount of bytes transferred within a single I2C transaction (size of the smallest Wire buffer among Arduino cores)
+#define CAP1188_I2C_BUFFER_LENGTH                        32
+
+// Used for MAIN CONTROL REGISTER (0x00), B0
+#define CAP1188_MAIN_CONTROL_INT_BIT                     0x01
+
+// Used for GENERAL STATUS REGISTER (0x02)
+#define CAP1188_GENERAL_STATUS_TOUCH_BIT                 0x01 // Any input is touched
+#define CAP1188_GENERAL_STATUS_MTP_BIT                   0x02 // Multiple touch pattern is detected
+#define CAP1188_GENERAL_STATUS_MULT_BIT                  0x04 // Too many simultaneous touches are detected
+#define CAP1188_GENERAL_STATUS_LED_BIT                   0x08 // LED is still ramping/breathing
+
+// Used for MAIN CONTROL REGISTER (0x00), B5-B4
+#define CAP1188_MAIN_CONTROL_STBY_BIT                    0x20
+#define CAP1188_MAIN_CONTROL_DSLEEP_BIT                  0x10
+
+// Power states of CAP1188 (see setPowerState(...))
+#define CAP1188_POWER_ACTIVE                             0x00 // All inputs are sensed using averaging and sampling configuration
+#define CAP1188_POWER_STANDBY                            0x01 // Only standby channels are sensed using standby configuration, sensitivity and threshold
+#define CAP1188_POWER_DEEP_SLEEP                         0x02 // Nothing is sensed (touches are not detected), registers are kept
+
+// Used for RECALIBRATION CONFIGURATION REGISTER (0x2F), B7
+#define CAP1188_RECALIBRATION_BUT_LD_TH_BIT              0x80
+
+// Version of CAP1188CalibrationSnapshot layout, stored snapshots of other versions are rejected by restoreCalibration(...)
+#define CAP1188_CALIBRATION_SNAPSHOT_VERSION             0x01
+
+// Default maximum difference of 10-bit calibration values (live vs snapshot), at which an input is not recalibrated
+#define CAP1188_CALIBRATION_TOLERANCE                    8
+
+// Amount of registers kept in shadow register file (total length of shadowRanges in CAP1188.cpp, checked at compile time)
+#define CAP1188_SHADOW_SIZE                              45
+
+// Touch event types reported by readEvent(...). Gesture events are only reported by CAP1188Gesture
+#define CAP1188_EVENT_PRESS                              0x01
+#define CAP1188_EVENT_RELEASE                            0x02
+#define CAP1188_EVENT_HOLD                               0x03 // Input is pressed for longer than hold time
+#define CAP1188_EVENT_REPEAT                             0x04 // Input is still pressed, sent every repeat period after hold
+#define CAP1188_EVENT_SLIDE_UP                           0x05 // Touch moved to the next input (input holds new input number)
+#define CAP1188_EVENT_SLIDE_DOWN                         0x06 // Touch moved to the previous input (input holds new input number)
+#define CAP1188_EVENT_PATTERN                            0x07 // Multiple touch pattern is detected (input holds touched inputs in binary format)
+
+// Amount of touch events buffered until they are read. Must be a power of 2
+#define CAP1188_EVENT_QUEUE_SIZE                         16
+
+// Amount of devices in interrupt driven mode at once on cores without attachInterruptArg(...) (other than ESP32/ESP8266),
+// as every device takes an interrupt handler of its own there
+#define CAP1188_MAX_ALERT_DEVICES                        4
+
+// FreeRTOS task settings used by startTask(...) on ESP32
+#define CAP1188_TASK_STACK_SIZE                          2048
+#define CAP1188_TASK_PRIORITY                            5
+// Amount of asynchronous requests queued for the task
+#define CAP1188_ASYNC_QUEUE_LENGTH                       8
+
+// Asynchronous request operations
+#define CAP1188_ASYNC_ALERT                              0x00
+#define CAP1188_ASYNC_READ                               0x01
+#define CAP1188_ASYNC_WRITE                              0x02
+#define CAP1188_ASYNC_SENSOR_INPUTS                      0x03
+#define CAP1188_ASYNC_STOP                               0x04 // Sent by stopTask(), arg is a semaphore given once task is done
+
+// Functions, which are called from interrupts, must be placed in IRAM on ESP
+#if defined(ESP32) || defined(ESP8266)
+#define CAP1188_ISR_ATTR                                 IRAM_ATTR
+#else
+#define CAP1188_ISR_ATTR
+#endif
+
+// Driver code of touch read path (sensor inputs, INT clear and register access underneath them) is placed in IRAM on ESP32,
+// so it is not fetched through flash cache. Wire, SPI and core functions it calls (i.e. digitalWrite(), delay()) stay where
+// the core puts them, so the path still may miss flash cache and must not run while cache is disabled.
+// Attribute is only given on definitions, as IRAM_ATTR puts every occurrence in a section of its own.
+// Define CAP1188_HOT_ATTR as empty (i.e. via build flags) to keep it in flash.
+// Initialisation and configuration is marked as cold, so compiler optimises it for size
+#if !defined(CAP1188_HOT_ATTR)
+#if defined(ESP32)
+#define CAP1188_HOT_ATTR                                 IRAM_ATTR
+#else
+#define CAP1188_HOT_ATTR
+#endif
+#endif
+#if defined(__GNUC__)
+#define CAP1188_COLD_ATTR                                __attribute__((cold))
+#else
+#define CAP1188_COLD_ATTR
+#endif
+
+// Bus statistics (see getStats()) are only collected if CAP1188_ENABLE_STATS is defined (i.e. via build flags)
+// Operation types of latency histogram
+#define CAP1188_STATS_READ                               0x00
+#define CAP1188_STATS_WRITE                              0x01
+#define CAP1188_STATS_RMW                                0x02
+#define CAP1188_STATS_BURST_READ                         0x03
+#define CAP1188_STATS_BURST_WRITE                        0x04
+#define CAP1188_STATS_EXCHANGE                           0x05 // Read and write within a single transaction (see exchangeRegisters(...))
+#define CAP1188_STATS_OPERATIONS                         6
+// Latency histogram buckets: <16us, <32us, <64us, ..., <1024us, >=1024us
+#define CAP1188_STATS_BUCKETS                            8
+#define CAP1188_STATS_FIRST_BUCKET_US                    16
+
+// Used to mark SPI register pointer of CAP1188 as not known by the driver
+#define CAP1188_REG_POINTER_UNKNOWN                      -1
+
+typedef uint8_t CAP1188Status;
+
+// Configuration profile applied by CAP1188::applyConfig(...). Fields are register images (see CAP1188_..._CONFIG(...) macros)
+// in register address order, so a profile can be a constexpr aggregate, i.e.:
+// constexpr CAP1188Config config = {CAP1188_AVERAGING_AND_SAMPLING_CONFIG(...), CAP1188_MULTIPLE_TOUCH_CONFIG(false, 1), {0x40, ...}, ...};
+struct CAP1188Config
+{
+    uint8_t averagingAndSampling; // AVERAGING AND SAMPLING CONFIG REGISTER (0x24)
+    uint8_t multipleTouch;        // MULTIPLE TOUCH CONFIGURATION REGISTER (0x2A)
+    uint8_t thresholds[8];        // SENSOR INPUT THRESHOLD REGISTERS (0x30-0x37)
+    uint8_t standby;              // STANDBY CONFIGURATION REGISTER (0x41)
+    uint8_t ledLinking;           // SENSOR INPUT LED LINKING REGISTER (0x72)
+};
+
+// LED engine configuration applied by CAP1188::applyLedConfig(...). Fields are register images (see CAP1188_LED_...(...) macros)
+// in register address order, so once applied, pulse/breathe/ramp effects run on CAP1188 without any bus traffic
+struct CAP1188LedConfig
+{
+    uint8_t behavior[2];          // LED BEHAVIOR REGISTERS (0x81-0x82), LED1-LED4 and LED5-LED8
+    uint8_t pulse1Period;         // LED PULSE 1 PERIOD REGISTER (0x84), including CAP1188_LED_PULSE_1_ON_...
+    uint8_t pulse2Period;         // LED PULSE 2 PERIOD REGISTER (0x85)
+    uint8_t breathePeriod;        // LED BREATHE PERIOD REGISTER (0x86)
+    uint8_t pulseCounts;          // LED CONFIG REGISTER (0x88)
+    uint8_t pulse1Duty;           // LED PULSE 1 DUTY CYCLE REGISTER (0x90)
+    uint8_t pulse2Duty;           // LED PULSE 2 DUTY CYCLE REGISTER (0x91)
+    uint8_t breatheDuty;          // LED BREATHE DUTY CYCLE REGISTER (0x92)
+    uint8_t directDuty;           // LED DIRECT DUTY CYCLE REGISTER (0x93)
+    uint8_t directRampRates;      // LED DIRECT RAMP RATES REGISTER (0x94)
+    uint8_t offDelays;            // LED OFF DELAY REGISTER (0x95)
+};
+
+// Snapshot of sensing configuration and calibration taken by CAP1188::saveCalibration(...). Fields are register images,
+// so the struct has no padding and can be stored as is (i.e. in NVS/EEPROM)
+struct CAP1188CalibrationSnapshot
+{
+    uint8_t version;              // CAP1188_CALIBRATION_SNAPSHOT_VERSION
+    uint8_t config[6];            // SENSITIVITY CONTROL ... AVERAGING AND SAMPLING CONFIG REGISTERS (0x1F-0x24)
+    uint8_t thresholds[8];        // SENSOR INPUT THRESHOLD REGISTERS (0x30-0x37)
+    uint8_t baseCounts[8];        // SENSOR INPUT BASE COUNT REGISTERS (0x50-0x57)
+    uint8_t calibration[10];      // SENSOR INPUT CALIBRATION and CALIBRATION LSB REGISTERS (0xB1-0xBA)
+};
+
+struct CAP1188Stats
+{
+    uint32_t transactions; // SPI CS frames, I2C transmissions or user transport calls
+    uint32_t bytes;        // Register bytes read or written
+    uint32_t errors;       // Failed operations (after all retries)
+    uint32_t retries;      // Retried reads or writes
+    uint32_t latency[CAP1188_STATS_OPERATIONS][CAP1188_STATS_BUCKETS]; // Operation count per latency bucket
+};
+
+// Takes or releases a user supplied bus lock (see CAP1188::setBusLock(...)). Lock has to be recursive
+typedef void (*CAP1188LockCallback)(void *arg);
+
+// Bus classes of Wire and SPI libraries (only included by CAP1188.cpp)
+#if !defined(CAP1188_DISABLE_I2C)
+class TwoWire;
+#endif
+#if !defined(CAP1188_DISABLE_SPI)
+class SPIClass;
+#endif
+
+// Interface of a user supplied transport, which accesses CAP1188 registers (see CAP1188::initTransport(...)).
+// CAP1188 increments register address after every byte, so consecutive registers are expected to be accessed in a single transaction
+class CAP1188Transport{
+    public:
+        virtual ~CAP1188Transport() {}
+        virtual bool readRegisters(uint8_t startAddress, uint8_t *buff, uint8_t len) = 0;
+        virtual bool writeRegisters(uint8_t startAddress, const uint8_t *buff, uint8_t len) = 0;
+};
+
+struct CAP1188Event
+{
+    uint32_t timestamp; // millis() at the moment ALERT was asserted (or sample was taken by CAP1188Gesture)
+    uint8_t type;       // CAP1188_EVENT_...
+    uint8_t input;      // Sensor input number between 1...8 (touched inputs in binary format for CAP1188_EVENT_PATTERN)
+};
+
+// Called from the task started by startTask(...) once an asynchronous request is done. Data is only valid during the call
+typedef void (*CAP1188Callback)(void *arg, bool success, const uint8_t *data, uint8_t len);
+
+// Asynchronous request executed by the task started by startTask(...)
+struct CAP1188AsyncRequest
+{
+    uint8_t operation; // CAP1188_ASYNC_...
+    uint8_t startAddress;
+    uint8_t len;
+    uint8_t data[CAP1188_MAX_BURST_LENGTH];
+    CAP1188Callback callback;
+    void *arg;
+};
+
+// Lock-free queue of touch events. Safe to use with a single producer and a single consumer running in different contexts
+class CAP1188EventQueue{
+    public:
+        CAP1188EventQueue();
+        bool push(const CAP1188Event &event);
+        bool pop(CAP1188Event *event);
+        uint8_t available();
+        void clear();
+
+    private:
+        CAP1188Event _events[CAP1188_EVENT_QUEUE_SIZE];
+        volatile uint8_t _head, _tail;
+};
+
 class CAP1188{
     public:
         CAP1188();
-        void initI2C(uint8_t address, uint8_t resetPin);
-        void initSPI(uint8_t csPin, uint8_t resetPin);
+        ~CAP1188();
+#if !defined(CAP1188_DISABLE_I2C)
+        void initI2C(uint8_t address, uint8_t resetPin, uint8_t initMode = CAP1188_INIT_COLD);
+        void initI2C(TwoWire &wire, uint8_t address, uint8_t resetPin, uint8_t initMode = CAP1188_INIT_COLD);
+        void setI2CClock(uint32_t clock);
+#endif
+#if !defined(CAP1188_DISABLE_SPI)
+        void initSPI(uint8_t csPin, uint8_t resetPin, uint8_t initMode = CAP1188_INIT_COLD);
+        void initSPI(SPIClass &spi, uint8_t csPin, uint8_t resetPin, uint8_t initMode = CAP1188_INIT_COLD);
+        void initSPI3Wire(uint8_t csPin, uint8_t sckPin, uint8_t sdioPin, uint8_t resetPin, uint8_t initMode = CAP1188_INIT_COLD);
+        void setSPIClock(uint32_t clock);
+#endif
+        void initTransport(CAP1188Transport &transport, uint8_t resetPin, uint8_t initMode = CAP1188_INIT_COLD);
+        bool isReady();
+        bool isWarmStart();
         uint8_t getProductId();
         uint8_t getManufacturerId();
         uint8_t getRevision();
         uint8_t getSensorInputs();
-        bool setMultipleTouchConfiguration(bool multipleTouchCircuitryEnable, uint8_t numberOfSimultaneousTouches);
-        bool setSensorInputLEDLinking(uint8_t ledsToLink);
+        bool setInterruptEnable(uint8_t inputs);
+#if CAP1188_HAS_FEATURE(CAP1188_FEATURE_STANDBY)
         bool setStandbyConfiguration(uint8_t averageSum, uint8_t samplesPerMeasurement, uint8_t samplingTime, uint8_t cycleTime);
         bool getStandbyConfiguration(uint8_t* averageSum, uint8_t *samplesPerMeasurement, uint8_t *samplingTime, uint8_t *cycleTime);
+        bool setStandbyChannels(uint8_t inputs);
+        uint8_t getStandbyChannels();
+        bool setStandbySensitivity(uint8_t sensitivity);
+        uint8_t getStandbySensitivity();
+        bool setStandbyThreshold(uint8_t threshold);
+        uint8_t getStandbyThreshold();
+        bool setPowerState(uint8_t state);
+        uint8_t getPowerState();
+#endif
+#if CAP1188_HAS_FEATURE(CAP1188_FEATURE_THRESHOLDS)
+        bool setMultipleTouchConfiguration(bool multipleTouchCircuitryEnable, uint8_t numberOfSimultaneousTouches);
+        bool setMultipleTouchPattern(bool enable, uint8_t pattern, uint8_t mode, uint8_t threshold, bool alert);
+        bool isMultipleTouchPatternDetected();
         bool setAveragingAndSamplingConfig(uint8_t samplesPerMeasurement, uint8_t samplingTime, uint8_t cycleTime);
         bool getAveragingAndSamplingConfig(uint8_t *samplesPerMeasurement, uint8_t *samplingTime, uint8_t *cycleTime);
         bool setSensorInputThreshold(uint8_t buttonNumber, uint8_t threshold);
         bool setSensorInputThresholdAll(uint8_t threshold);
         uint8_t getSensorInputThreshold(uint8_t inputNumber);
+        bool setSensorInputThresholds(const uint8_t thresholds[8]);
+        bool getSensorInputThresholds(uint8_t thresholds[8]);
+        bool setSensitivity(uint8_t sensitivity);
+        uint8_t getSensitivity();
+#endif
+#if CAP1188_HAS_FEATURE(CAP1188_FEATURE_COUNTS)
+        int8_t getDeltaCount(uint8_t inputNumber);
+        bool getDeltaCounts(int8_t deltaCounts[8]);
+        uint8_t getBaseCount(uint8_t inputNumber);
+        bool getBaseCounts(uint8_t baseCounts[8]);
+        uint16_t getCalibration(uint8_t inputNumber);
+        bool getCalibrations(uint16_t calibrations[8]);
+        bool recalibrate(uint8_t inputs);
+        uint8_t getCalibratingInputs();
+        bool saveCalibration(CAP1188CalibrationSnapshot *snapshot);
+        bool restoreCalibration(const CAP1188CalibrationSnapshot &snapshot, uint16_t tolerance = CAP1188_CALIBRATION_TOLERANCE);
+#endif
+        bool readRegisters(uint8_t startAddress, uint8_t* buff, uint8_t len);
+        bool writeRegisters(uint8_t startAddress, const uint8_t* buff, uint8_t len);
+        bool CAP1188_COLD_ATTR syncShadow();
+        bool CAP1188_COLD_ATTR applyConfig(const CAP1188Config &config);
+#if CAP1188_HAS_FEATURE(CAP1188_FEATURE_LED)
+        bool setSensorInputLEDLinking(uint8_t ledsToLink);
+        bool applyLedConfig(const CAP1188LedConfig &config);
+        bool setLedBehavior(uint8_t ledNumber, uint8_t behavior);
+        void setLeds(uint8_t leds);
+        bool setLed(uint8_t ledNumber, bool on);
+        uint8_t getLeds();
+        bool flushLeds();
+        uint8_t getSensorInputsAndFlushLeds();
+#endif
+        CAP1188Status getLastStatus();
+        void setRetryPolicy(uint8_t retries, uint16_t backoffUs);
+        void setBusLock(CAP1188LockCallback lock, CAP1188LockCallback unlock, void *arg = NULL);
+#if defined(ESP32)
+        void setBusMutex(SemaphoreHandle_t mutex);
+#endif
+        void lockBus();
+        void unlockBus();
+#if defined(CAP1188_ENABLE_STATS)
+        const CAP1188Stats &getStats();
+        void resetStats();
+#endif
+        bool attachAlert(uint8_t alertPin);
+        void detachAlert();
+        bool processAlert();
+        bool readEvent(CAP1188Event *event);
+        uint8_t eventsAvailable();
+        bool isAlertAttached();
+        bool isAlertPending();
+        uint8_t getLastSensorInputs();
+#if defined(ESP32)
+        bool startTask(uint32_t stackSize = CAP1188_TASK_STACK_SIZE, UBaseType_t priority = CAP1188_TASK_PRIORITY, BaseType_t core = tskNO_AFFINITY);
+        bool stopTask();
+        bool isTaskRunning();
+        bool readRegistersAsync(uint8_t startAddress, uint8_t len, CAP1188Callback callback, void *arg = NULL);
+        bool writeRegistersAsync(uint8_t startAddress, const uint8_t *buff, uint8_t len, CAP1188Callback callback = NULL, void *arg = NULL);
+        bool getSensorInputsAsync(CAP1188Callback callback, void *arg = NULL);
+#endif
 
     private:
+        void CAP1188_COLD_ATTR initDevice(uint8_t initMode);
+        void CAP1188_COLD_ATTR startDevice();
+        bool CAP1188_COLD_ATTR isConfigured();
+        bool clearInterrupt();
+        bool readSensorInputs(uint8_t *keys);
+        static void alertISR(void *arg);
+#if !defined(ESP32) && !defined(ESP8266)
+        template <uint8_t slot> static void alertSlotISR();
+        static CAP1188 *_alertDevices[CAP1188_MAX_ALERT_DEVICES]; // Device serviced by interrupt handler of every slot
+        static void (*const _alertSlotISRs[CAP1188_MAX_ALERT_DEVICES])();
+#endif
+#if defined(ESP32)
+        static void taskLoop(void *arg);
+        bool queueRequest(const CAP1188AsyncRequest &request);
+        void releaseBusMutex();
+#endif
+        void pushInputEvents(uint8_t inputs, uint32_t timestamp);
+        CAP1188Status busReadRegisters(uint8_t startAddress, uint8_t* buff, uint8_t len);
+        CAP1188Status busWriteRegisters(uint8_t startAddress, const uint8_t* buff, uint8_t len);
+        CAP1188Status busExchangeRegisters(uint8_t readAddress, uint8_t* readBuff, uint8_t readLen, uint8_t writeAddress, const uint8_t* writeBuff, uint8_t writeLen);
+        bool exchangeRegisters(uint8_t readAddress, uint8_t* readBuff, uint8_t readLen, uint8_t writeAddress, const uint8_t* writeBuff, uint8_t writeLen);
+        bool retryAfter(uint8_t attempt);
+#if defined(CAP1188_ENABLE_STATS)
+        void recordStats(uint8_t operation, uint8_t bytes, bool success, uint32_t latency);
+#endif
+        bool readRegister(uint8_t regAddress, uint8_t* data);
+        bool writeRegister(uint8_t regAddress, uint8_t data);
+        bool modifyRegister(uint8_t regAddress, uint8_t mask, uint8_t value);
+        // Shadow register file related functions start
+        int8_t shadowIndex(uint8_t regAddress);
+        bool getShadow(uint8_t regAddress, uint8_t* data);
+        void updateShadow(uint8_t startAddress, const uint8_t* data, uint8_t len);
+        void updateWrittenShadow(uint8_t startAddress, const uint8_t* buff, uint8_t len);
+        void invalidateShadow();
+        bool writeChangedRegisters(uint8_t startAddress, const uint8_t* buff, uint8_t len);
+        void broadcastThresholdShadow(uint8_t threshold, uint16_t endAddress);
+        // Shadow register file related functions end
+#if !defined(CAP1188_DISABLE_I2C)
+        // I2C related functions start
+        CAP1188Status i2cReadRegisters(uint8_t regAddress, uint8_t* data, uint8_t len, bool sendStop = true);
+        CAP1188Status i2cWriteRegisters(uint8_t regAddress, const uint8_t* data, uint8_t len);
+        CAP1188Status i2cStatus(uint8_t result);
+        // I2C related functions end
+#endif
+#if !defined(CAP1188_DISABLE_SPI)
         // SPI related functions start
         void readRegisterFromAddress(uint8_t regAddress, uint8_t* data);
+        void readRegistersFromAddress(uint8_t regAddress, uint8_t* data, uint8_t len);
         bool writeRegisterAtAddress(uint8_t regAddress, uint8_t data);
-        bool setRegisterAddress(uint8_t regAddress);
-        uint8_t readRegister();
-        bool writeRegister(uint8_t data);
-        bool resetSPI();
+        void writeRegistersAtAddress(uint8_t regAddress, const uint8_t* data, uint8_t len);
+        void exchangeRegistersAtAddress(uint8_t readAddress, uint8_t* readData, uint8_t readLen, uint8_t writeAddress, const uint8_t* writeData, uint8_t writeLen);
+        void spiTransfer(uint8_t* buff, uint8_t len);
+        void spi3WireTransfer(uint8_t* buff, uint8_t len);
+        void spi3WireWrite(uint8_t data, uint32_t halfPeriodUs);
+        uint8_t spi3WireRead(uint32_t halfPeriodUs);
+        bool CAP1188_COLD_ATTR resetSPI();
+        void invalidateRegisterPointer();
+        void advanceRegisterPointer(uint8_t count);
         // SPI related functions end
-        bool _i2c;
-        int8_t _i2cAddress, _resetPin, _csPin;
-};
\ No newline at end of file
+#endif
+        uint8_t _interface; // CAP1188_INTERFACE_... selected during initialisation
+        CAP1188Status _lastStatus;
+        uint8_t _retries;
+        uint16_t _retryBackoffUs;
+        uint8_t _i2cAddress, _resetPin, _csPin;
+        uint8_t _sckPin, _sdioPin; // Used by SPI 3-wire (bi-directional) mode only
+        bool _spi3Wire;
+        bool _sdioOutput; // SPI 3-wire data line is driven by the driver (otherwise it is released to CAP1188)
+        CAP1188Transport *_transport;
+#if !defined(CAP1188_DISABLE_I2C)
+        TwoWire *_wire;
+#endif
+#if !defined(CAP1188_DISABLE_SPI)
+        SPIClass *_spi;
+#endif
+        uint32_t _spiClock;
+        int16_t _regPointer; // Last known SPI register pointer of CAP1188 (CAP1188_REG_POINTER_UNKNOWN if not known)
+        uint8_t _initState; // CAP1188_INIT_STATE_...
+        bool _warmStart;
+        uint32_t _resetStart; // millis() when reset pulse of CAP1188_INIT_NO_WAIT started
+        uint8_t _shadow[CAP1188_SHADOW_SIZE]; // Write-through copy of configuration registers
+        uint8_t _shadowValid[(CAP1188_SHADOW_SIZE + 7) / 8]; // Bit per shadowed register, set if register state is known
+        int8_t _alertPin;
+        volatile bool _alertPending;
+        volatile uint32_t _alertTimestamp;
+        uint8_t _lastInputs; // Sensor inputs reported by the last serviced ALERT
+        uint8_t _leds; // LED OUTPUT CONTROL REGISTER contents buffered by setLeds(...)/setLed(...)
+        bool _ledsDirty; // Set if _leds has to be flushed
+        CAP1188EventQueue _events;
+        CAP1188LockCallback _lock, _unlock;
+        void *_lockArg;
+#if defined(CAP1188_ENABLE_STATS)
+        CAP1188Stats _stats;
+#endif
+#if defined(ESP32)
+        TaskHandle_t _task;
+        QueueHandle_t _queue;
+        SemaphoreHandle_t _busMutex;
+        bool _ownBusMutex; // _busMutex was created by startTask(...), so it is deleted by stopTask()
+        volatile bool _taskStopping; // Set by stopTask(), no further requests are queued
+#endif
+};
+
+#endif
@@ -0,0 +1,149 @@
+#include "CAP1188Bus.h"
+
+/**
+ * @brief Instantiates an empty group of CAP1188 devices. Add initialised devices using *.addDevice(...)
+ */
+CAP1188Bus::CAP1188Bus() : _deviceCount(0), _nextPolled(0){};
+
+/**
+ * @brief Adds an initialised CAP1188 device to the group. Device has to outlive the group
+ * @param device initialised CAP1188 device (via I2C or SPI)
+ * @return true on success, false if group is full
+ */
+bool CAP1188Bus::addDevice(CAP1188 &device)
+{
+    if (_deviceCount >= CAP1188_BUS_MAX_DEVICES)
+    {
+        return false;
+    }
+    _devices[_deviceCount] = &device;
+    _inputs[_deviceCount] = 0;
+    _deviceCount++;
+    return true;
+}
+
+/**
+ * @brief Returns amount of devices in the group
+ * @return amount of devices
+ */
+uint8_t CAP1188Bus::getDeviceCount()
+{
+    return _deviceCount;
+}
+
+/**
+ * @brief Returns a device of the group
+ * @param deviceNumber number of a device in order it was added (starting from 0)
+ * @return pointer to a device, NULL if there is no such device
+ */
+CAP1188 *CAP1188Bus::getDevice(uint8_t deviceNumber)
+{
+    if (deviceNumber >= _deviceCount)
+    {
+        return NULL;
+    }
+    return _devices[deviceNumber];
+}
+
+/**
+ * @brief Reads current sensor inputs of all devices and combines them into a single touch map.
+ * Devices in interrupt driven mode without pending ALERT are not accessed
+ * @return touch map, where bit 8*N+(I-1) is set if input I of device N is pressed
+ */
+uint64_t CAP1188Bus::getTouchMap()
+{
+    for (uint8_t i = 0; i < _deviceCount; i++)
+    {
+        readDevice(i);
+    }
+    return scan(0);
+}
+
+/**
+ * @brief Reads sensor inputs of a limited amount of devices and returns a touch map combined with last known
+ * sensor inputs of other devices. Devices with pending ALERT are read first, then polled devices round-robin.
+ * Useful to spread bus traffic of many devices over several loop iterations
+ * @param maxReads maximum amount of devices to read
+ * @return touch map, where bit 8*N+(I-1) is set if input I of device N is pressed
+ */
+uint64_t CAP1188Bus::scan(uint8_t maxReads)
+{
+    // Devices, which signalled a change, go first
+    for (uint8_t i = 0; i < _deviceCount && maxReads; i++)
+    {
+        if (_devices[i]->isAlertAttached() && _devices[i]->isAlertPending() && !isTaskServiced(i))
+        {
+            // Bus was not accessed if ALERT got serviced elsewhere in the meantime (failed read leaves it pending)
+            if (readDevice(i) || _devices[i]->isAlertPending())
+            {
+                maxReads--;
+            }
+        }
+    }
+
+    // Polled devices share remaining reads
+    for (uint8_t polled = 0; polled < _deviceCount && maxReads; polled++)
+    {
+        uint8_t i = _nextPolled;
+        _nextPolled = (_nextPolled + 1) % _deviceCount;
+        if (!_devices[i]->isAlertAttached())
+        {
+            readDevice(i);
+            maxReads--;
+        }
+    }
+
+    uint64_t touchMap = 0;
+    for (uint8_t i = 0; i < _deviceCount; i++)
+    {
+        touchMap |= (uint64_t)_inputs[i] << (8 * i);
+    }
+    return touchMap;
+}
+
+/**
+ * @brief Updates last known sensor inputs of a device
+ * @param deviceNumber number of a device in order it was added (starting from 0)
+ * @return true if sensor inputs were read, false if device had nothing to report or bus error occurred
+ * (last known sensor inputs are kept then)
+ */
+bool CAP1188Bus::readDevice(uint8_t deviceNumber)
+{
+    CAP1188 *device = _devices[deviceNumber];
+    if (device->isAlertAttached())
+    {
+        if (isTaskServiced(deviceNumber))
+        {
+            // Task services ALERT itself, processAlert() would race it
+            _inputs[deviceNumber] = device->getLastSensorInputs();
+            return false;
+        }
+        // Sensor inputs only change when ALERT is asserted, failed service does not update them
+        bool serviced = device->processAlert();
+        _inputs[deviceNumber] = device->getLastSensorInputs();
+        return serviced;
+    }
+    uint8_t inputs = device->getSensorInputs();
+    if (device->getLastStatus() != CAP1188_STATUS_OK)
+    {
+        return false;
+    }
+    _inputs[deviceNumber] = inputs;
+    return true;
+}
+
+/**
+ * @brief Checks if ALERT of a device is serviced by the task of the device (see CAP1188::startTask(...)), in which case
+ * the group only takes sensor inputs reported by the last serviced ALERT
+ * @param deviceNumber number of a device in order it was added (starting from 0)
+ * @return true if device has a running task, false otherwise
+ */
+bool CAP1188Bus::isTaskServiced(uint8_t deviceNumber)
+{
+#if defined(ESP32)
+    return _devices[deviceNumber]->isTaskRunning();
+#else
+    (void)deviceNumber; // No task without FreeRTOS
+    return false;
+#endif
+}
@@ -0,0 +1,31 @@
+#ifndef _CAP1188_BUS_H_
+#define _CAP1188_BUS_H_
+
+#include "CAP1188.h"
+
+// Maximum amount of CAP1188 devices handled by a single CAP1188Bus (touch map holds 8 bits per device)
+#define CAP1188_BUS_MAX_DEVICES                          8
+
+// Groups several initialised CAP1188 devices (on I2C and/or SPI) and combines their sensor inputs into a single touch map.
+// Device number N (in order of addDevice(...) calls) owns bits 8*N...8*N+7 of the touch map.
+// Devices in interrupt driven mode (see CAP1188::attachAlert(...)) are only read when their ALERT is pending,
+// other devices are polled round-robin. ALERT of a device with a running task (see CAP1188::startTask(...)) is left to the task
+class CAP1188Bus{
+    public:
+        CAP1188Bus();
+        bool addDevice(CAP1188 &device);
+        uint8_t getDeviceCount();
+        CAP1188 *getDevice(uint8_t deviceNumber);
+        uint64_t getTouchMap();
+        uint64_t scan(uint8_t maxReads);
+
+    private:
+        bool readDevice(uint8_t deviceNumber);
+        bool isTaskServiced(uint8_t deviceNumber);
+        CAP1188 *_devices[CAP1188_BUS_MAX_DEVICES];
+        uint8_t _inputs[CAP1188_BUS_MAX_DEVICES];
+        uint8_t _deviceCount;
+        uint8_t _nextPolled; // Device to start next round-robin poll from
+};
+
+#endif
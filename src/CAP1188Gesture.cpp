@@ -0,0 +1,224 @@
+#include "CAP1188Gesture.h"
+
+#if CAP1188_HAS_FEATURE(CAP1188_FEATURE_COUNTS)
+/**
+ * @brief Instantiates a new gesture engine with default thresholds and timing. Attach a device using *.begin(...)
+ * or feed delta counts using *.feed(...)
+ */
+CAP1188Gesture::CAP1188Gesture() : _device(NULL), _holdMs(CAP1188_GESTURE_HOLD_MS), _repeatMs(CAP1188_GESTURE_REPEAT_MS),
+                                   _slideMs(CAP1188_GESTURE_SLIDE_MS)
+{
+    setThresholds(CAP1188_GESTURE_PRESS_THRESHOLD, CAP1188_GESTURE_RELEASE_THRESHOLD);
+    reset();
+};
+
+/**
+ * @brief Attaches an initialised CAP1188 device, delta counts of which are read by *.update(). Device has to outlive gesture engine
+ * @param device initialised CAP1188 device
+ * @return void
+ */
+void CAP1188Gesture::begin(CAP1188 &device)
+{
+    _device = &device;
+    reset();
+}
+
+/**
+ * @brief Sets delta count thresholds. Using release threshold below press threshold (hysteresis) rejects noise around a threshold
+ * @param pressThreshold delta count above which input is pressed (1...127)
+ * @param releaseThreshold delta count below which input is released (has to be <= pressThreshold)
+ * @return void
+ */
+void CAP1188Gesture::setThresholds(uint8_t pressThreshold, uint8_t releaseThreshold)
+{
+    _pressThreshold = (int16_t)pressThreshold << CAP1188_GESTURE_FIXED_POINT_SHIFT;
+    _releaseThreshold = (int16_t)releaseThreshold << CAP1188_GESTURE_FIXED_POINT_SHIFT;
+}
+
+/**
+ * @brief Sets timing of hold, repeat and slide events
+ * @param holdMs time input has to be pressed for before hold event is reported (0 to disable hold and repeat events)
+ * @param repeatMs period of repeat events after hold event (0 to disable repeat events)
+ * @param slideMs max time between release of an input and press of the adjacent one to report a slide (0 to disable slide events)
+ * @return void
+ */
+void CAP1188Gesture::setTiming(uint16_t holdMs, uint16_t repeatMs, uint16_t slideMs)
+{
+    _holdMs = holdMs;
+    _repeatMs = repeatMs;
+    _slideMs = slideMs;
+}
+
+/**
+ * @brief Reads delta counts of all inputs from attached device within a single burst and processes them (see *.feed(...)).
+ * Has to be called periodically, ideally once per sensing cycle of CAP1188
+ * @return true on success, false on error or if no device is attached
+ */
+bool CAP1188Gesture::update()
+{
+    int8_t deltas[8];
+    if (_device == NULL || !_device->getDeltaCounts(deltas))
+    {
+        return false;
+    }
+    feed(deltas, millis());
+    return true;
+}
+
+/**
+ * @brief Processes a sample of delta counts of all inputs and reports resulting events
+ * @param deltas delta counts of inputs 1...8
+ * @param timestamp time when the sample was taken in milliseconds
+ * @return void
+ */
+void CAP1188Gesture::feed(const int8_t deltas[8], uint32_t timestamp)
+{
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        int16_t delta = (int16_t)deltas[i] << CAP1188_GESTURE_FIXED_POINT_SHIFT;
+        _filtered[i] += (delta - _filtered[i]) >> CAP1188_GESTURE_FILTER_SHIFT;
+
+        bool pressed = _pressed & (1 << i);
+        // Pressed input is checked against release threshold and released input against press threshold
+        bool crossing = pressed ? _filtered[i] < _releaseThreshold : _filtered[i] >= _pressThreshold;
+        if (!crossing)
+        {
+            _debounce[i] = 0;
+        }
+        else if (++_debounce[i] >= CAP1188_GESTURE_DEBOUNCE_SAMPLES)
+        {
+            _debounce[i] = 0;
+            if (pressed)
+            {
+                releaseInput(i, timestamp);
+            }
+            else
+            {
+                pressInput(i, timestamp);
+            }
+            continue;
+        }
+
+        if (pressed && _holdMs && (int32_t)(timestamp - _deadline[i]) >= 0)
+        {
+            if (!(_held & (1 << i)))
+            {
+                _held |= 1 << i;
+                pushEvent(timestamp, CAP1188_EVENT_HOLD, i);
+            }
+            else
+            {
+                pushEvent(timestamp, CAP1188_EVENT_REPEAT, i);
+            }
+            // Without repeat events the deadline is pushed as far as possible
+            _deadline[i] = timestamp + (_repeatMs ? _repeatMs : 0x7FFFFFFF);
+        }
+    }
+}
+
+/**
+ * @brief Reads the oldest event
+ * @param event buffer to receive event in to
+ * @return true if event was read, false if there are no events
+ */
+bool CAP1188Gesture::readEvent(CAP1188Event *event)
+{
+    return _events.pop(event);
+}
+
+/**
+ * @brief Returns amount of events, which can be read by readEvent(...)
+ * @return amount of events
+ */
+uint8_t CAP1188Gesture::eventsAvailable()
+{
+    return _events.available();
+}
+
+/**
+ * @brief Returns debounced state of inputs
+ * @return inputs pressed in binary format (bit 0 is input 1)
+ */
+uint8_t CAP1188Gesture::getPressed()
+{
+    return _pressed;
+}
+
+/**
+ * @brief Releases all inputs without reporting events and drops buffered events
+ * @return void
+ */
+void CAP1188Gesture::reset()
+{
+    memset(_filtered, 0, sizeof(_filtered));
+    memset(_debounce, 0, sizeof(_debounce));
+    memset(_deadline, 0, sizeof(_deadline));
+    _pressed = 0;
+    _held = 0;
+    _slideIndex = -1;
+    _slideTime = 0;
+    _events.clear();
+}
+
+/**
+ * @brief Adds an event to the queue. Event is dropped if queue is full
+ * @param timestamp time of an event
+ * @param type CAP1188_EVENT_...
+ * @param index index of an input (0...7)
+ * @return void
+ */
+void CAP1188Gesture::pushEvent(uint32_t timestamp, uint8_t type, uint8_t index)
+{
+    CAP1188Event event;
+    event.timestamp = timestamp;
+    event.type = type;
+    event.input = index + 1;
+    _events.push(event);
+}
+
+/**
+ * @brief Marks an input as pressed and reports press event (followed by slide event if adjacent input was touched recently)
+ * @param index index of an input (0...7)
+ * @param timestamp time of a press
+ * @return void
+ */
+void CAP1188Gesture::pressInput(uint8_t index, uint32_t timestamp)
+{
+    _pressed |= 1 << index;
+    _held &= ~(1 << index);
+    _deadline[index] = timestamp + _holdMs;
+    pushEvent(timestamp, CAP1188_EVENT_PRESS, index);
+
+    if (_slideMs && _slideIndex >= 0 && (timestamp - _slideTime <= _slideMs || (_pressed & (1 << _slideIndex))))
+    {
+        if (_slideIndex == index - 1)
+        {
+            pushEvent(timestamp, CAP1188_EVENT_SLIDE_UP, index);
+        }
+        else if (_slideIndex == index + 1)
+        {
+            pushEvent(timestamp, CAP1188_EVENT_SLIDE_DOWN, index);
+        }
+    }
+    _slideIndex = index;
+    _slideTime = timestamp;
+}
+
+/**
+ * @brief Marks an input as released and reports release event
+ * @param index index of an input (0...7)
+ * @param timestamp time of a release
+ * @return void
+ */
+void CAP1188Gesture::releaseInput(uint8_t index, uint32_t timestamp)
+{
+    _pressed &= ~(1 << index);
+    _held &= ~(1 << index);
+    pushEvent(timestamp, CAP1188_EVENT_RELEASE, index);
+    if (_slideIndex == index)
+    {
+        _slideTime = timestamp;
+    }
+}
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef _CAP1188_GESTURE_H_
+#define _CAP1188_GESTURE_H_
+
+#include "CAP1188.h"
+
+// Only available if required features are compiled in (see CAP1188_FEATURES)
+#if CAP1188_HAS_FEATURE(CAP1188_FEATURE_COUNTS)
+
+// Default delta count thresholds of CAP1188Gesture (touch is detected above press and released below release threshold)
+#define CAP1188_GESTURE_PRESS_THRESHOLD                  32
+#define CAP1188_GESTURE_RELEASE_THRESHOLD                24
+
+// Default timing of CAP1188Gesture in milliseconds
+#define CAP1188_GESTURE_HOLD_MS                          500
+#define CAP1188_GESTURE_REPEAT_MS                        100
+#define CAP1188_GESTURE_SLIDE_MS                         150 // Max time between release of an input and press of the adjacent one
+
+// Amount of consecutive samples crossing a threshold required to change state of an input
+#define CAP1188_GESTURE_DEBOUNCE_SAMPLES                 2
+
+// Delta counts are low-pass filtered as filtered += (delta - filtered) / 2^CAP1188_GESTURE_FILTER_SHIFT (0 to disable)
+#define CAP1188_GESTURE_FILTER_SHIFT                     2
+
+// Fractional bits of filtered delta counts
+#define CAP1188_GESTURE_FIXED_POINT_SHIFT                4
+
+// Host side touch detection for a single CAP1188. Delta counts of all inputs are read within a single burst, filtered
+// (fixed-point), compared against thresholds with hysteresis and debounced. Resulting press, release, hold, repeat and
+// slide (across adjacent inputs) events are buffered in a fixed-size queue. No memory is allocated
+class CAP1188Gesture{
+    public:
+        CAP1188Gesture();
+        void begin(CAP1188 &device);
+        void setThresholds(uint8_t pressThreshold, uint8_t releaseThreshold);
+        void setTiming(uint16_t holdMs, uint16_t repeatMs, uint16_t slideMs);
+        bool update();
+        void feed(const int8_t deltas[8], uint32_t timestamp);
+        bool readEvent(CAP1188Event *event);
+        uint8_t eventsAvailable();
+        uint8_t getPressed();
+        void reset();
+
+    private:
+        void pushEvent(uint32_t timestamp, uint8_t type, uint8_t input);
+        void pressInput(uint8_t index, uint32_t timestamp);
+        void releaseInput(uint8_t index, uint32_t timestamp);
+        CAP1188 *_device;
+        int16_t _pressThreshold, _releaseThreshold; // Fixed-point
+        uint16_t _holdMs, _repeatMs, _slideMs;
+        int16_t _filtered[8]; // Fixed-point filtered delta counts
+        uint8_t _debounce[8]; // Consecutive samples crossing the threshold
+        uint32_t _deadline[8]; // Time of the next hold or repeat event of a pressed input
+        uint8_t _pressed; // Bit per pressed input
+        uint8_t _held; // Bit per input, which reported hold event
+        int8_t _slideIndex; // Input last pressed or released (-1 if none)
+        uint32_t _slideTime; // Time when _slideIndex was last pressed or released
+        CAP1188EventQueue _events;
+};
+#endif
+
+#endif
@@ -0,0 +1,162 @@
+#include "CAP1188Governor.h"
+
+#if CAP1188_HAS_FEATURE(CAP1188_FEATURE_STANDBY) && CAP1188_HAS_FEATURE(CAP1188_FEATURE_THRESHOLDS)
+/**
+ * @brief Instantiates a new governor with default profiles: active - 2 samples of 1.28ms every 35ms on all inputs,
+ * standby - average of 8 samples of 1.28ms every 140ms on all inputs. Attach a device using *.begin(...)
+ */
+CAP1188Governor::CAP1188Governor() : _device(NULL), _activeSamples(CAP1188_SAMPLES_PER_MEASUREMENT_2), _activeSamplingTime(CAP1188_SAMPLING_TIME_1_28ms),
+                                     _activeCycleTime(CAP1188_CYCLE_TIME_35ms), _standbyChannels(0xFF), _standbyAverageSum(CAP1188_AVG_SUM_AVG),
+                                     _standbySamples(CAP1188_SAMPLES_PER_MEASUREMENT_8), _standbySamplingTime(CAP1188_SAMPLING_TIME_1_28ms),
+                                     _standbyCycleTime(CAP1188_CYCLE_TIME_140ms), _idleMs(CAP1188_GOVERNOR_IDLE_MS), _lastActivity(0), _standby(false){};
+
+/**
+ * @brief Attaches an initialised CAP1188 device, writes both profiles and switches to active profile. Device has to outlive governor
+ * @param device initialised CAP1188 device
+ * @return true on success, false on error
+ */
+bool CAP1188Governor::begin(CAP1188 &device)
+{
+    _device = &device;
+    _lastActivity = millis();
+    return applyActiveProfile() && applyStandbyProfile() && setStandby(false);
+}
+
+/**
+ * @brief Sets active profile (see CAP1188::setAveragingAndSamplingConfig(...)). Written to CAP1188 right away if device is attached
+ * @param samplesPerMeasurement use CAP1188_SAMPLES_PER_MEASUREMENT_...
+ * @param samplingTime use CAP1188_SAMPLING_TIME_...
+ * @param cycleTime use CAP1188_CYCLE_TIME_... (CAP1188_CYCLE_TIME_35ms for the fastest response)
+ * @return true on success, false on error
+ */
+bool CAP1188Governor::setActiveProfile(uint8_t samplesPerMeasurement, uint8_t samplingTime, uint8_t cycleTime)
+{
+    _activeSamples = samplesPerMeasurement;
+    _activeSamplingTime = samplingTime;
+    _activeCycleTime = cycleTime;
+    return _device == NULL || applyActiveProfile();
+}
+
+/**
+ * @brief Sets standby profile (see CAP1188::setStandbyConfiguration(...)). Written to CAP1188 right away if device is attached
+ * @param channels inputs sensed in standby in binary format (i.e. 0b00000001 to only wake up by input 1)
+ * @param averageSum use CAP1188_AVG_SUM_...
+ * @param samplesPerMeasurement use CAP1188_SAMPLES_PER_MEASUREMENT_...
+ * @param samplingTime use CAP1188_SAMPLING_TIME_...
+ * @param cycleTime use CAP1188_CYCLE_TIME_...
+ * @return true on success, false on error
+ */
+bool CAP1188Governor::setStandbyProfile(uint8_t channels, uint8_t averageSum, uint8_t samplesPerMeasurement, uint8_t samplingTime, uint8_t cycleTime)
+{
+    _standbyChannels = channels;
+    _standbyAverageSum = averageSum;
+    _standbySamples = samplesPerMeasurement;
+    _standbySamplingTime = samplingTime;
+    _standbyCycleTime = cycleTime;
+    return _device == NULL || applyStandbyProfile();
+}
+
+/**
+ * @brief Sets time without touches after which standby profile is used
+ * @param idleMs idle time in milliseconds
+ * @return void
+ */
+void CAP1188Governor::setIdleTimeout(uint32_t idleMs)
+{
+    _idleMs = idleMs;
+}
+
+/**
+ * @brief Reads sensor inputs of attached device and switches profile if required (see *.update(uint8_t inputs)).
+ * NOTE: Use update(inputs) instead if sensor inputs are already read by the application
+ * @return true on success, false on error
+ */
+bool CAP1188Governor::update()
+{
+    if (_device == NULL)
+    {
+        return false;
+    }
+    uint8_t inputs = _device->getSensorInputs();
+    if (inputs == 0 && _device->getLastStatus() != CAP1188_STATUS_OK)
+    {
+        return false;
+    }
+    return update(inputs);
+}
+
+/**
+ * @brief Switches to active profile if any input is touched, or to standby profile after idle time without touches.
+ * Has to be called periodically (see *.getPollInterval())
+ * @param inputs sensor inputs in binary format (i.e. returned by CAP1188::getSensorInputs())
+ * @return true on success, false on error
+ */
+bool CAP1188Governor::update(uint8_t inputs)
+{
+    uint32_t now = millis();
+    if (inputs)
+    {
+        _lastActivity = now;
+        return !_standby || setStandby(false);
+    }
+    if (!_standby && now - _lastActivity >= _idleMs)
+    {
+        return setStandby(true);
+    }
+    return true;
+}
+
+/**
+ * @brief Checks which profile is used
+ * @return true if standby profile is used, false if active one
+ */
+bool CAP1188Governor::isStandby()
+{
+    return _standby;
+}
+
+/**
+ * @brief Returns cycle time of the current profile, which is the longest reasonable period between update() calls
+ * @return poll interval in milliseconds
+ */
+uint16_t CAP1188Governor::getPollInterval()
+{
+    // CAP1188_CYCLE_TIME_... N stands for (N + 1) * 35ms
+    return ((_standby ? _standbyCycleTime : _activeCycleTime) + 1) * 35;
+}
+
+/**
+ * @brief Writes active profile to CAP1188
+ * @return true on success, false on error
+ */
+bool CAP1188Governor::applyActiveProfile()
+{
+    return _device->setAveragingAndSamplingConfig(_activeSamples, _activeSamplingTime, _activeCycleTime);
+}
+
+/**
+ * @brief Writes standby profile (including standby channels) to CAP1188
+ * @return true on success, false on error
+ */
+bool CAP1188Governor::applyStandbyProfile()
+{
+    return _device->setStandbyChannels(_standbyChannels) &&
+           _device->setStandbyConfiguration(_standbyAverageSum, _standbySamples, _standbySamplingTime, _standbyCycleTime);
+}
+
+/**
+ * @brief Puts CAP1188 into or out of standby (see CAP1188::setPowerState(...))
+ * @param standby true to use standby profile, false to use active one
+ * @return true on success, false on error
+ */
+bool CAP1188Governor::setStandby(bool standby)
+{
+    if (!_device->setPowerState(standby ? CAP1188_POWER_STANDBY : CAP1188_POWER_ACTIVE))
+    {
+        return false;
+    }
+    _standby = standby;
+    return true;
+}
+
+#endif
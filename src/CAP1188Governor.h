@@ -0,0 +1,40 @@
+#ifndef _CAP1188_GOVERNOR_H_
+#define _CAP1188_GOVERNOR_H_
+
+#include "CAP1188.h"
+
+// Only available if required features are compiled in (see CAP1188_FEATURES)
+#if CAP1188_HAS_FEATURE(CAP1188_FEATURE_STANDBY) && CAP1188_HAS_FEATURE(CAP1188_FEATURE_THRESHOLDS)
+
+// Default time without touches after which CAP1188Governor puts CAP1188 into standby
+#define CAP1188_GOVERNOR_IDLE_MS                         5000
+
+// Switches a single CAP1188 between active and standby profiles to trade response time for power/polling cost.
+// Active profile uses short cycle time on all inputs, standby profile only senses standby channels (0x40) with longer
+// cycle time. Any touch switches back to active profile, profile is switched to standby after configurable idle time
+class CAP1188Governor{
+    public:
+        CAP1188Governor();
+        bool begin(CAP1188 &device);
+        bool setActiveProfile(uint8_t samplesPerMeasurement, uint8_t samplingTime, uint8_t cycleTime);
+        bool setStandbyProfile(uint8_t channels, uint8_t averageSum, uint8_t samplesPerMeasurement, uint8_t samplingTime, uint8_t cycleTime);
+        void setIdleTimeout(uint32_t idleMs);
+        bool update();
+        bool update(uint8_t inputs);
+        bool isStandby();
+        uint16_t getPollInterval();
+
+    private:
+        bool applyActiveProfile();
+        bool applyStandbyProfile();
+        bool setStandby(bool standby);
+        CAP1188 *_device;
+        uint8_t _activeSamples, _activeSamplingTime, _activeCycleTime;
+        uint8_t _standbyChannels, _standbyAverageSum, _standbySamples, _standbySamplingTime, _standbyCycleTime;
+        uint32_t _idleMs;
+        uint32_t _lastActivity; // millis() of the last touch
+        bool _standby;
+};
+#endif
+
+#endif
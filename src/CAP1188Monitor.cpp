@@ -0,0 +1,206 @@
+#include "CAP1188Monitor.h"
+#include "CAP1188_reg.h"
+
+#if CAP1188_HAS_FEATURE(CAP1188_FEATURE_COUNTS)
+/**
+ * @brief Instantiates a new monitor with default limits. Attach a device using *.begin(...)
+ */
+CAP1188Monitor::CAP1188Monitor() : _device(NULL), _driftLimit(CAP1188_MONITOR_DRIFT_LIMIT), _noiseLimit(CAP1188_MONITOR_NOISE_LIMIT),
+                                   _generalStatus(0), _inputs(0), _noiseFlags(0), _calibrating(0), _recalibrations(0)
+{
+    memset(_baseCounts, 0, sizeof(_baseCounts));
+    memset(_references, 0, sizeof(_references));
+    memset(_noiseCount, 0, sizeof(_noiseCount));
+};
+
+/**
+ * @brief Attaches an initialised (and calibrated) CAP1188 device and captures current base counts as references.
+ * Device has to outlive monitor
+ * @param device initialised CAP1188 device
+ * @return true on success, false on error
+ */
+bool CAP1188Monitor::begin(CAP1188 &device)
+{
+    _device = &device;
+    _calibrating = 0;
+    memset(_noiseCount, 0, sizeof(_noiseCount));
+    if (!_device->getBaseCounts(_baseCounts))
+    {
+        return false;
+    }
+    captureReferences(0xFF);
+    return true;
+}
+
+/**
+ * @brief Sets limits at which an input is recalibrated
+ * @param driftLimit base count drift from reference (0 to never recalibrate on drift)
+ * @param noiseLimit consecutive updates with noise flag set (0 to never recalibrate on noise)
+ * @return void
+ */
+void CAP1188Monitor::setLimits(uint8_t driftLimit, uint8_t noiseLimit)
+{
+    _driftLimit = driftLimit;
+    _noiseLimit = noiseLimit;
+}
+
+/**
+ * @brief Reads status, noise flags and base counts, then recalibrates inputs, which are not touched and either drifted
+ * away from their reference or were noisy for too long. References of recalibrated inputs are captured again after
+ * CAP1188 finishes calibration. Has to be called periodically
+ * @return true on success, false on error
+ */
+bool CAP1188Monitor::update()
+{
+    if (_device == NULL)
+    {
+        return false;
+    }
+
+    // Calibration state is read before base counts, so references of finished inputs are captured from base counts
+    // sampled after calibration ended
+    uint8_t done = 0;
+    if (_calibrating)
+    {
+        done = _calibrating & ~_device->getCalibratingInputs();
+        if (_device->getLastStatus() != CAP1188_STATUS_OK)
+        {
+            return false;
+        }
+    }
+
+    // GENERAL STATUS (0x02), SENSOR INPUT STATUS (0x03), LED STATUS (0x04), reserved (0x05-0x09), NOISE FLAG STATUS (0x0A)
+    uint8_t status[CAP1188_NOISE_FLAG_STATUS_REG - CAP1188_GENERAL_STATUS_REG + 1];
+    if (!_device->readRegisters(CAP1188_GENERAL_STATUS_REG, status, sizeof(status)) || !_device->getBaseCounts(_baseCounts))
+    {
+        return false;
+    }
+    _generalStatus = status[0];
+    _inputs = status[CAP1188_SENSOR_INPUT_STATUS_REG - CAP1188_GENERAL_STATUS_REG];
+    _noiseFlags = status[CAP1188_NOISE_FLAG_STATUS_REG - CAP1188_GENERAL_STATUS_REG];
+
+    captureReferences(done);
+    _calibrating &= ~done;
+
+    uint8_t recalibrate = 0;
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        uint8_t bit = 1 << i;
+        if (_noiseFlags & bit)
+        {
+            if (_noiseCount[i] < 0xFF)
+            {
+                _noiseCount[i]++;
+            }
+        }
+        else
+        {
+            _noiseCount[i] = 0;
+        }
+
+        if ((_inputs | _calibrating) & bit)
+        {
+            continue;
+        }
+        int16_t drift = getDrift(i + 1);
+        if ((_driftLimit && (drift >= _driftLimit || drift <= -_driftLimit)) || (_noiseLimit && _noiseCount[i] >= _noiseLimit))
+        {
+            recalibrate |= bit;
+        }
+    }
+
+    if (recalibrate)
+    {
+        if (!_device->recalibrate(recalibrate))
+        {
+            return false;
+        }
+        for (uint8_t i = 0; i < 8; i++)
+        {
+            if (recalibrate & (1 << i))
+            {
+                _noiseCount[i] = 0;
+                _recalibrations++;
+            }
+        }
+        _calibrating |= recalibrate;
+    }
+    return true;
+}
+
+/**
+ * @brief Returns GENERAL STATUS REGISTER read by the last update (see CAP1188_GENERAL_STATUS_..._BIT)
+ * @return general status
+ */
+uint8_t CAP1188Monitor::getGeneralStatus()
+{
+    return _generalStatus;
+}
+
+/**
+ * @brief Returns SENSOR INPUT STATUS REGISTER read by the last update. NOTE: INT is not cleared by the monitor
+ * @return touched inputs in binary format
+ */
+uint8_t CAP1188Monitor::getSensorInputs()
+{
+    return _inputs;
+}
+
+/**
+ * @brief Returns NOISE FLAG STATUS REGISTER read by the last update
+ * @return inputs with noise above noise threshold in binary format
+ */
+uint8_t CAP1188Monitor::getNoiseFlags()
+{
+    return _noiseFlags;
+}
+
+/**
+ * @brief Returns base count drift of a sensor input from its reference as of the last update
+ * @param inputNumber number of a sensor input between 1...8
+ * @return base count minus reference base count, 0 if input number is wrong
+ */
+int16_t CAP1188Monitor::getDrift(uint8_t inputNumber)
+{
+    if (inputNumber < 1 || inputNumber > 8)
+    {
+        return 0;
+    }
+    return (int16_t)_baseCounts[inputNumber - 1] - _references[inputNumber - 1];
+}
+
+/**
+ * @brief Returns inputs recalibrated by the monitor, which did not finish calibration as of the last update
+ * @return calibrating inputs in binary format
+ */
+uint8_t CAP1188Monitor::getCalibratingInputs()
+{
+    return _calibrating;
+}
+
+/**
+ * @brief Returns amount of input recalibrations started by the monitor
+ * @return amount of recalibrations
+ */
+uint32_t CAP1188Monitor::getRecalibrationCount()
+{
+    return _recalibrations;
+}
+
+/**
+ * @brief Captures the last read base counts of selected inputs as their references
+ * @param inputs inputs in binary format
+ * @return void
+ */
+void CAP1188Monitor::captureReferences(uint8_t inputs)
+{
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        if (inputs & (1 << i))
+        {
+            _references[i] = _baseCounts[i];
+        }
+    }
+}
+
+#endif
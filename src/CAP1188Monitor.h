@@ -0,0 +1,46 @@
+#ifndef _CAP1188_MONITOR_H_
+#define _CAP1188_MONITOR_H_
+
+#include "CAP1188.h"
+
+// Only available if required features are compiled in (see CAP1188_FEATURES)
+#if CAP1188_HAS_FEATURE(CAP1188_FEATURE_COUNTS)
+
+// Default base count drift (from base count captured after calibration) at which an input is recalibrated
+#define CAP1188_MONITOR_DRIFT_LIMIT                      32
+
+// Default amount of consecutive updates with noise flag set at which an input is recalibrated (0 to never recalibrate on noise)
+#define CAP1188_MONITOR_NOISE_LIMIT                      8
+
+// Watches noise flags and base count drift of a single CAP1188 and recalibrates only affected inputs.
+// Every update reads general status, sensor input status and noise flags (0x02-0x0A) within a single burst
+// and base counts (0x50-0x57) within another one, preceded by CALIBRATION ACTIVATE (0x26) while recalibrated inputs did not
+// finish calibration yet. Touched inputs are never recalibrated
+class CAP1188Monitor{
+    public:
+        CAP1188Monitor();
+        bool begin(CAP1188 &device);
+        void setLimits(uint8_t driftLimit, uint8_t noiseLimit);
+        bool update();
+        uint8_t getGeneralStatus();
+        uint8_t getSensorInputs();
+        uint8_t getNoiseFlags();
+        int16_t getDrift(uint8_t inputNumber);
+        uint8_t getCalibratingInputs();
+        uint32_t getRecalibrationCount();
+
+    private:
+        void captureReferences(uint8_t inputs);
+        CAP1188 *_device;
+        uint8_t _driftLimit;
+        uint8_t _noiseLimit;
+        uint8_t _generalStatus, _inputs, _noiseFlags;
+        uint8_t _baseCounts[8];
+        uint8_t _references[8]; // Base counts captured after calibration
+        uint8_t _noiseCount[8]; // Consecutive updates with noise flag set
+        uint8_t _calibrating; // Inputs recalibrated by the monitor, which did not finish calibration yet
+        uint32_t _recalibrations;
+};
+#endif
+
+#endif
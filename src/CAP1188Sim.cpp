@@ -0,0 +1,315 @@
+#include "CAP1188Sim.h"
+#include "CAP1188_reg.h"
+
+// Power-on defaults of CAP1188 registers, which differ from 0
+static const struct
+{
+    uint8_t regAddress;
+    uint8_t value;
+} defaultRegs[] = {
+    {CAP1188_SENSITIVITY_CONTROL_REG, 0x2F},
+    {CAP1188_CONFIGURATION_REG, 0x20},
+    {CAP1188_SENSOR_INPUT_ENABLE_REG, 0xFF},
+    {CAP1188_SENSOR_INPUT_CONFIGURATION_REG, 0xA4},
+    {CAP1188_SENSOR_INPUT_CONFIGURATION_2_REG, 0x07},
+    {CAP1188_AVERAGING_AND_SAMPLING_CONFIG_REG, 0x39},
+    {CAP1188_INTERRUPT_ENABLE_REG, 0xFF},
+    {CAP1188_REPEAT_RATE_ENABLE_REG, 0xFF},
+    {CAP1188_MULTIPLE_TOUCH_CONFIGURATION_REG, 0x80},
+    {CAP1188_MULTIPLE_TOUCH_PATTERN_REG, 0xFF},
+    {CAPP1188_RECALIBRATION_CONFIGURATION_REG, 0x8A},
+    {CAP1188_SENSOR_INPUT_1_THRESHOLD_REG, 0x40},
+    {CAP1188_SENSOR_INPUT_2_THRESHOLD_REG, 0x40},
+    {CAP1188_SENSOR_INPUT_3_THRESHOLD_REG, 0x40},
+    {CAP1188_SENSOR_INPUT_4_THRESHOLD_REG, 0x40},
+    {CAP1188_SENSOR_INPUT_5_THRESHOLD_REG, 0x40},
+    {CAP1188_SENSOR_INPUT_6_THRESHOLD_REG, 0x40},
+    {CAP1188_SENSOR_INPUT_7_THRESHOLD_REG, 0x40},
+    {CAP1188_SENSOR_INPUT_8_THRESHOLD_REG, 0x40},
+    {CAP1188_SENSOR_INPUT_NOISE_THRESHOLD_REG, 0x01},
+    {CAP1188_STANDBY_CONFIGURATION_REG, 0x39},
+    {CAP1188_STANDBY_SENSITIVITY_REG, 0x02},
+    {CAP1188_STANDBY_THRESHOLD_REG, 0x40},
+    {CAP1188_CONFIGURATION_2_REG, 0x40},
+    {CAP1188_LED_PULSE_1_PERIOD_REG, 0x20},
+    {CAP1188_LED_PULSE_2_PERIOD_REG, 0x14},
+    {CAP1188_LED_BREATHE_PERIOD_REG, 0x5D},
+    {CAP1188_LED_CONFIG_REG, 0x04},
+    {CAP1188_LED_PULSE_1_DUTY_CYCLE_REG, 0xF0},
+    {CAP1188_LED_PULSE_2_DUTY_CYCLE_REG, 0xF0},
+    {CAP1188_LED_BREATHE_DUTY_CYCLE_REG, 0xF0},
+    {CAP1188_LED_DIRECT_DUTY_CYCLE_REG, 0xF0},
+    {CAP1188_PRODUCT_ID_REG, 0x50},
+    {CAP1188_MANUFACTURER_ID_REG, 0x5D},
+    {CAP1188_REVISION_REG, 0x83},
+};
+
+/**
+ * @brief Instantiates a simulated CAP1188 in its power-on state, modelling I2C bus at 100 kHz
+ */
+CAP1188Sim::CAP1188Sim() : _bus(CAP1188_SIM_BUS_I2C), _clock(100000)
+{
+    reset();
+    resetCounters();
+};
+
+/**
+ * @brief Brings all registers back to their power-on defaults (same as RESET pin of CAP1188)
+ * @return void
+ */
+void CAP1188Sim::reset()
+{
+    memset(_regs, 0, sizeof(_regs));
+    for (uint8_t i = 0; i < sizeof(defaultRegs) / sizeof(defaultRegs[0]); i++)
+    {
+        _regs[defaultRegs[i].regAddress] = defaultRegs[i].value;
+    }
+    _touches = 0;
+    _regPointer = -1;
+}
+
+/**
+ * @brief Reads several consecutive registers (CAP1188Transport)
+ * @param startAddress first register address to read from
+ * @param buff buffer to receive register contents in to
+ * @param len amount of registers to read
+ * @return true
+ */
+bool CAP1188Sim::readRegisters(uint8_t startAddress, uint8_t *buff, uint8_t len)
+{
+    countTransaction(startAddress, len, true);
+    for (uint8_t i = 0; i < len; i++)
+    {
+        buff[i] = _regs[(uint8_t)(startAddress + i)];
+    }
+    return true;
+}
+
+/**
+ * @brief Writes several consecutive registers (CAP1188Transport). Writes to read-only registers are ignored
+ * @param startAddress first register address to write to
+ * @param buff buffer with register contents to write
+ * @param len amount of registers to write
+ * @return true
+ */
+bool CAP1188Sim::writeRegisters(uint8_t startAddress, const uint8_t *buff, uint8_t len)
+{
+    countTransaction(startAddress, len, false);
+    for (uint8_t i = 0; i < len; i++)
+    {
+        writeRegister(startAddress + i, buff[i]);
+    }
+    return true;
+}
+
+/**
+ * @brief Selects a bus and its clock frequency used to estimate bus time
+ * @param bus CAP1188_SIM_BUS_I2C or CAP1188_SIM_BUS_SPI
+ * @param clock bus clock frequency in Hz
+ * @return void
+ */
+void CAP1188Sim::setBusModel(uint8_t bus, uint32_t clock)
+{
+    _bus = bus;
+    _clock = clock;
+    _regPointer = -1;
+}
+
+/**
+ * @brief Simulates touches of sensor inputs. Every change asserts INT (if enabled for these inputs by INTERRUPT ENABLE REGISTER),
+ * and touched inputs are latched in SENSOR INPUT STATUS REGISTER until INT is cleared
+ * @param inputs inputs touched (bit 0 is input 1)
+ * @return void
+ */
+void CAP1188Sim::setTouches(uint8_t inputs)
+{
+    if ((inputs ^ _touches) & _regs[CAP1188_INTERRUPT_ENABLE_REG])
+    {
+        _regs[CAP1188_MAIN_CONTROL_REG] |= CAP1188_MAIN_CONTROL_INT_BIT;
+    }
+    _touches = inputs;
+    _regs[CAP1188_SENSOR_INPUT_STATUS_REG] |= inputs;
+}
+
+/**
+ * @brief Sets content of Sensor Input Delta Count registers
+ * @param deltaCounts delta counts of sensor inputs 1...8
+ * @return void
+ */
+void CAP1188Sim::setDeltaCounts(const int8_t deltaCounts[8])
+{
+    memcpy(&_regs[CAP1188_SENSOR_INPUT_1_DELTA_COUNT_REG], deltaCounts, 8);
+}
+
+/**
+ * @brief Sets content of Sensor Input Base Count registers
+ * @param baseCounts base counts of sensor inputs 1...8
+ * @return void
+ */
+void CAP1188Sim::setBaseCounts(const uint8_t baseCounts[8])
+{
+    memcpy(&_regs[CAP1188_SENSOR_INPUT_1_BASE_COUNT_REG], baseCounts, 8);
+}
+
+/**
+ * @brief Reads a register bypassing bus model (not counted)
+ * @param regAddress register address
+ * @return register content
+ */
+uint8_t CAP1188Sim::peekRegister(uint8_t regAddress)
+{
+    return _regs[regAddress];
+}
+
+/**
+ * @brief Writes a register bypassing bus model and register access rules (not counted), i.e. to set read-only registers
+ * @param regAddress register address
+ * @param data register content
+ * @return void
+ */
+void CAP1188Sim::pokeRegister(uint8_t regAddress, uint8_t data)
+{
+    _regs[regAddress] = data;
+}
+
+/**
+ * @brief Returns amount of bus transactions (SPI CS frames or I2C start conditions) since the last resetCounters()
+ * @return amount of transactions
+ */
+uint32_t CAP1188Sim::getTransactions()
+{
+    return _transactions;
+}
+
+/**
+ * @brief Returns amount of bytes transferred on the bus (including commands and addresses) since the last resetCounters()
+ * @return amount of bytes
+ */
+uint32_t CAP1188Sim::getBytes()
+{
+    return _bytes;
+}
+
+/**
+ * @brief Returns estimated bus time since the last resetCounters() (clocking only, no software overhead)
+ * @return bus time in microseconds
+ */
+uint32_t CAP1188Sim::getBusTimeUs()
+{
+    return _busTimeNs / 1000;
+}
+
+/**
+ * @brief Resets transaction, byte and bus time counters
+ * @return void
+ */
+void CAP1188Sim::resetCounters()
+{
+    _transactions = 0;
+    _bytes = 0;
+    _busTimeNs = 0;
+}
+
+/**
+ * @brief Accounts a register access the way it is framed on a selected bus by the driver
+ * @param startAddress first register address
+ * @param len amount of registers
+ * @param read true for reads, false for writes
+ * @return void
+ */
+void CAP1188Sim::countTransaction(uint8_t startAddress, uint8_t len, bool read)
+{
+    uint32_t bytes = 0, bits = 0;
+    if (_bus == CAP1188_SIM_BUS_SPI)
+    {
+        // Every register takes a command (0x7F/0x7E) and a data byte, reads overlap them apart from the last dummy byte.
+        // Set address command is only sent if register pointer differs
+        for (uint16_t done = 0; done < len; done += CAP1188_MAX_BURST_LENGTH)
+        {
+            uint8_t chunk = len - done > CAP1188_MAX_BURST_LENGTH ? CAP1188_MAX_BURST_LENGTH : len - done;
+            bytes += read ? chunk + 1 : 2 * chunk;
+            if (_regPointer != startAddress + done)
+            {
+                bytes += 2;
+            }
+            _regPointer = startAddress + done + chunk;
+            if (_regPointer > 0xFF)
+            {
+                // Same as the driver (see CAP1188::advanceRegisterPointer(...)), pointer beyond last register is not known
+                _regPointer = -1;
+            }
+            _transactions++;
+        }
+        bits = 8 * bytes;
+    }
+    else
+    {
+        // Writes: address + register + data. Reads: address + register, repeated start, address + data.
+        // Every byte takes 9 clocks (with ACK), start/stop conditions take about a clock each
+        uint8_t maxChunk = read ? CAP1188_I2C_BUFFER_LENGTH : CAP1188_I2C_BUFFER_LENGTH - 1;
+        for (uint16_t done = 0; done < len; done += maxChunk)
+        {
+            uint8_t chunk = len - done > maxChunk ? maxChunk : len - done;
+            uint8_t chunkBytes = read ? chunk + 3 : chunk + 2;
+            bytes += chunkBytes;
+            bits += 9 * chunkBytes + (read ? 3 : 2);
+            _transactions += read ? 2 : 1;
+        }
+    }
+    _bytes += bytes;
+    _busTimeNs += (uint64_t)bits * 1000000000ULL / _clock;
+}
+
+/**
+ * @brief Writes a register applying register access rules of CAP1188
+ * @param regAddress register address
+ * @param data register content
+ * @return void
+ */
+void CAP1188Sim::writeRegister(uint8_t regAddress, uint8_t data)
+{
+    switch (regAddress)
+    {
+    case CAP1188_MAIN_CONTROL_REG:
+        if (!(data & CAP1188_MAIN_CONTROL_INT_BIT))
+        {
+            // Clearing INT releases latched inputs, which are no longer touched
+            _regs[CAP1188_SENSOR_INPUT_STATUS_REG] = _touches;
+        }
+        _regs[regAddress] = data;
+        break;
+
+    case CAP1188_CALIBRATION_ACTIVATE_REG:
+        // Calibration is done instantly, so the register clears itself right away
+        break;
+
+    case CAP1188_SENSOR_INPUT_1_THRESHOLD_REG:
+        if (_regs[CAPP1188_RECALIBRATION_CONFIGURATION_REG] & CAP1188_RECALIBRATION_BUT_LD_TH_BIT)
+        {
+            memset(&_regs[CAP1188_SENSOR_INPUT_1_THRESHOLD_REG], data, 8);
+        }
+        _regs[regAddress] = data;
+        break;
+
+    case CAP1188_GENERAL_STATUS_REG:
+    case CAP1188_SENSOR_INPUT_STATUS_REG:
+    case CAP1188_LED_STATUS_REG:
+    case CAP1188_NOISE_FLAG_STATUS_REG:
+    case CAP1188_PRODUCT_ID_REG:
+    case CAP1188_MANUFACTURER_ID_REG:
+    case CAP1188_REVISION_REG:
+        // Read-only
+        break;
+
+    default:
+        if ((regAddress >= CAP1188_SENSOR_INPUT_1_DELTA_COUNT_REG && regAddress <= CAP1188_SENSOR_INPUT_8_DELTA_COUNT_REG) ||
+            (regAddress >= CAP1188_SENSOR_INPUT_1_BASE_COUNT_REG && regAddress <= CAP1188_SENSOR_INPUT_8_BASE_COUNT_REG) ||
+            (regAddress >= CAP1188_SENSOR_INPUT_1_CALIBRATION_REG && regAddress <= CAP1188_SENSOR_INPUT_CALIBRATION_LSB_2_REG))
+        {
+            // Read-only
+            break;
+        }
+        _regs[regAddress] = data;
+        break;
+    }
+}
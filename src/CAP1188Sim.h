@@ -0,0 +1,43 @@
+#ifndef _CAP1188_SIM_H_
+#define _CAP1188_SIM_H_
+
+#include "CAP1188.h"
+
+// Bus models used by CAP1188Sim to estimate bus time
+#define CAP1188_SIM_BUS_I2C                              0x00
+#define CAP1188_SIM_BUS_SPI                              0x01
+
+// Software model of CAP1188 registers, which can be used as a transport (see CAP1188::initTransport(...)) to run the driver
+// off-target. Counts transactions and bytes the same access would take on a real bus, and estimates bus time of them.
+// Modelled behaviour: read-only registers, INT bit and latched sensor input status, threshold broadcast (BUT_LD_TH),
+// self-clearing CALIBRATION ACTIVATE register. Analog behaviour (sampling, calibration, LEDs) is not modelled
+class CAP1188Sim : public CAP1188Transport{
+    public:
+        CAP1188Sim();
+        void reset();
+        bool readRegisters(uint8_t startAddress, uint8_t *buff, uint8_t len);
+        bool writeRegisters(uint8_t startAddress, const uint8_t *buff, uint8_t len);
+        void setBusModel(uint8_t bus, uint32_t clock);
+        void setTouches(uint8_t inputs);
+        void setDeltaCounts(const int8_t deltaCounts[8]);
+        void setBaseCounts(const uint8_t baseCounts[8]);
+        uint8_t peekRegister(uint8_t regAddress);
+        void pokeRegister(uint8_t regAddress, uint8_t data);
+        uint32_t getTransactions();
+        uint32_t getBytes();
+        uint32_t getBusTimeUs();
+        void resetCounters();
+
+    private:
+        void countTransaction(uint8_t startAddress, uint8_t len, bool read);
+        void writeRegister(uint8_t regAddress, uint8_t data);
+        uint8_t _regs[256];
+        uint8_t _touches;
+        uint8_t _bus;
+        uint32_t _clock;
+        int16_t _regPointer; // SPI register pointer, so pointer caching of the driver is accounted for
+        uint32_t _transactions, _bytes;
+        uint64_t _busTimeNs;
+};
+
+#endif
@@ -0,0 +1,187 @@
+#include "CAP1188Telemetry.h"
+#include "CAP1188_reg.h"
+
+#if CAP1188_HAS_FEATURE(CAP1188_FEATURE_COUNTS)
+/**
+ * @brief Instantiates a new telemetry stream. Start it using *.begin(...)
+ */
+CAP1188Telemetry::CAP1188Telemetry() : _device(NULL), _output(NULL), _callback(NULL), _arg(NULL), _buffer(NULL), _framesPerHalf(0),
+                                       _frames(0), _half(0), _sequence(0), _intervalUs(0), _lastSample(0)
+{
+    memset(_baseCounts, 0, sizeof(_baseCounts));
+};
+
+/**
+ * @brief Starts a telemetry stream, which writes frames to a Print (i.e. Serial)
+ * @param device initialised CAP1188 device (has to outlive telemetry stream)
+ * @param buffer double buffer (has to fit at least 2 * CAP1188_TELEMETRY_FRAME_SIZE bytes and outlive telemetry stream)
+ * @param size size of a buffer in bytes
+ * @param output Print to write frames to
+ * @return true on success, false if buffer is too small
+ */
+bool CAP1188Telemetry::begin(CAP1188 &device, uint8_t *buffer, uint16_t size, Print &output)
+{
+    _output = &output;
+    _callback = NULL;
+    return begin(device, buffer, size);
+}
+
+/**
+ * @brief Starts a telemetry stream, which passes frames to a callback
+ * @param device initialised CAP1188 device (has to outlive telemetry stream)
+ * @param buffer double buffer (has to fit at least 2 * CAP1188_TELEMETRY_FRAME_SIZE bytes and outlive telemetry stream)
+ * @param size size of a buffer in bytes
+ * @param callback function to receive filled halves of the buffer
+ * @param arg user argument passed to callback
+ * @return true on success, false if buffer is too small
+ */
+bool CAP1188Telemetry::begin(CAP1188 &device, uint8_t *buffer, uint16_t size, CAP1188TelemetryCallback callback, void *arg)
+{
+    _output = NULL;
+    _callback = callback;
+    _arg = arg;
+    return begin(device, buffer, size);
+}
+
+/**
+ * @brief Sets period of samples taken by *.update()
+ * @param intervalUs sample period in microseconds (0 to take a sample within every call)
+ * @return void
+ */
+void CAP1188Telemetry::setInterval(uint32_t intervalUs)
+{
+    _intervalUs = intervalUs;
+}
+
+/**
+ * @brief Takes a sample if sample period elapsed since the last one. Has to be called continuously
+ * @return true on success (or if it is not time for a sample yet), false on error
+ */
+bool CAP1188Telemetry::update()
+{
+    uint32_t now = micros();
+    if (now - _lastSample < _intervalUs)
+    {
+        return true;
+    }
+    _lastSample = now;
+    return sample();
+}
+
+/**
+ * @brief Reads a sample and appends it as a frame to the buffer. Filled half of the buffer is emitted right away
+ * @return true on success, false on error (no frame is added)
+ */
+bool CAP1188Telemetry::sample()
+{
+    if (_device == NULL)
+    {
+        return false;
+    }
+
+    uint32_t timestamp = micros();
+    // GENERAL STATUS (0x02) ... SENSOR INPUT 8 DELTA COUNT (0x17)
+    uint8_t regs[CAP1188_SENSOR_INPUT_8_DELTA_COUNT_REG - CAP1188_GENERAL_STATUS_REG + 1];
+    if (!_device->readRegisters(CAP1188_GENERAL_STATUS_REG, regs, sizeof(regs)))
+    {
+        return false;
+    }
+    if (_sequence % CAP1188_TELEMETRY_BASE_COUNT_DIVIDER == 0 && !_device->getBaseCounts(_baseCounts))
+    {
+        return false;
+    }
+
+    uint8_t *frame = _buffer + ((uint16_t)_half * _framesPerHalf + _frames) * CAP1188_TELEMETRY_FRAME_SIZE;
+    frame[0] = CAP1188_TELEMETRY_SYNC_1;
+    frame[1] = CAP1188_TELEMETRY_SYNC_2;
+    frame[2] = _sequence++;
+    frame[3] = timestamp;
+    frame[4] = timestamp >> 8;
+    frame[5] = timestamp >> 16;
+    frame[6] = timestamp >> 24;
+    frame[7] = regs[0];
+    frame[8] = regs[CAP1188_SENSOR_INPUT_STATUS_REG - CAP1188_GENERAL_STATUS_REG];
+    frame[9] = regs[CAP1188_NOISE_FLAG_STATUS_REG - CAP1188_GENERAL_STATUS_REG];
+    memcpy(&frame[10], &regs[CAP1188_SENSOR_INPUT_1_DELTA_COUNT_REG - CAP1188_GENERAL_STATUS_REG], 8);
+    memcpy(&frame[18], _baseCounts, 8);
+    uint8_t checksum = 0;
+    for (uint8_t i = 2; i < CAP1188_TELEMETRY_FRAME_SIZE - 1; i++)
+    {
+        checksum += frame[i];
+    }
+    frame[CAP1188_TELEMETRY_FRAME_SIZE - 1] = checksum;
+
+    if (++_frames == _framesPerHalf)
+    {
+        emit(_frames);
+    }
+    return true;
+}
+
+/**
+ * @brief Emits frames of a partially filled half of the buffer (i.e. before stopping the stream)
+ * @return void
+ */
+void CAP1188Telemetry::flush()
+{
+    if (_frames)
+    {
+        emit(_frames);
+    }
+}
+
+/**
+ * @brief Returns amount of frames emitted at once (frames fitting a half of the buffer)
+ * @return amount of frames
+ */
+uint16_t CAP1188Telemetry::getFramesPerBuffer()
+{
+    return _framesPerHalf;
+}
+
+/**
+ * @brief Shared part of begin(...) functions
+ * @param device initialised CAP1188 device
+ * @param buffer double buffer
+ * @param size size of a buffer in bytes
+ * @return true on success, false if buffer is too small
+ */
+bool CAP1188Telemetry::begin(CAP1188 &device, uint8_t *buffer, uint16_t size)
+{
+    _framesPerHalf = size / 2 / CAP1188_TELEMETRY_FRAME_SIZE;
+    if (_framesPerHalf == 0)
+    {
+        _device = NULL;
+        return false;
+    }
+    _device = &device;
+    _buffer = buffer;
+    _frames = 0;
+    _half = 0;
+    _sequence = 0;
+    _lastSample = micros() - _intervalUs;
+    return true;
+}
+
+/**
+ * @brief Emits frames of the half being filled and switches to the other half
+ * @param frames amount of frames to emit
+ * @return void
+ */
+void CAP1188Telemetry::emit(uint16_t frames)
+{
+    const uint8_t *data = _buffer + (uint16_t)_half * _framesPerHalf * CAP1188_TELEMETRY_FRAME_SIZE;
+    uint16_t len = frames * CAP1188_TELEMETRY_FRAME_SIZE;
+    if (_output != NULL)
+    {
+        _output->write(data, len);
+    }
+    else if (_callback != NULL)
+    {
+        _callback(_arg, data, len);
+    }
+    _half ^= 1;
+    _frames = 0;
+}
+
+#endif
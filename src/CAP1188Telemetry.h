@@ -0,0 +1,61 @@
+#ifndef _CAP1188_TELEMETRY_H_
+#define _CAP1188_TELEMETRY_H_
+
+#include "CAP1188.h"
+
+// Only available if required features are compiled in (see CAP1188_FEATURES)
+#if CAP1188_HAS_FEATURE(CAP1188_FEATURE_COUNTS)
+
+// Telemetry frame layout (multi-byte fields are little-endian):
+//  0-1:   sync bytes CAP1188_TELEMETRY_SYNC_1, CAP1188_TELEMETRY_SYNC_2
+//  2:     sequence number (incremented with every frame)
+//  3-6:   micros() when the sample was taken
+//  7:     GENERAL STATUS REGISTER (0x02)
+//  8:     SENSOR INPUT STATUS REGISTER (0x03)
+//  9:     NOISE FLAG STATUS REGISTER (0x0A)
+//  10-17: delta counts of inputs 1...8 (signed)
+//  18-25: base counts of inputs 1...8 (refreshed every CAP1188_TELEMETRY_BASE_COUNT_DIVIDER frames)
+//  26:    checksum (sum of bytes 2-25 modulo 256)
+#define CAP1188_TELEMETRY_FRAME_SIZE                     27
+#define CAP1188_TELEMETRY_SYNC_1                         0xC1
+#define CAP1188_TELEMETRY_SYNC_2                         0x88
+
+// Base counts change slowly, so they are only read within every N-th frame (1 to read them within every frame)
+#define CAP1188_TELEMETRY_BASE_COUNT_DIVIDER             8
+
+// Receives a half of the double buffer holding complete frames. Buffer stays untouched until the other half is emitted
+typedef void (*CAP1188TelemetryCallback)(void *arg, const uint8_t *frames, uint16_t len);
+
+// Streams raw counts of a single CAP1188 as fixed-size binary frames (i.e. for tuning). Status and delta counts (0x02-0x17)
+// are read within a single burst per frame. Frames are collected in a caller provided double buffer and every filled half
+// is written to a Print (i.e. Serial) or passed to a callback, while the other half is being filled. No memory is allocated
+class CAP1188Telemetry{
+    public:
+        CAP1188Telemetry();
+        bool begin(CAP1188 &device, uint8_t *buffer, uint16_t size, Print &output);
+        bool begin(CAP1188 &device, uint8_t *buffer, uint16_t size, CAP1188TelemetryCallback callback, void *arg = NULL);
+        void setInterval(uint32_t intervalUs);
+        bool update();
+        bool sample();
+        void flush();
+        uint16_t getFramesPerBuffer();
+
+    private:
+        bool begin(CAP1188 &device, uint8_t *buffer, uint16_t size);
+        void emit(uint16_t frames);
+        CAP1188 *_device;
+        Print *_output;
+        CAP1188TelemetryCallback _callback;
+        void *_arg;
+        uint8_t *_buffer;
+        uint16_t _framesPerHalf; // Frames per half of the buffer
+        uint16_t _frames; // Frames in the half being filled
+        uint8_t _half; // Half of the buffer being filled (0 or 1)
+        uint8_t _sequence;
+        uint8_t _baseCounts[8];
+        uint32_t _intervalUs;
+        uint32_t _lastSample; // micros() of the last sample taken by update()
+};
+#endif
+
+#endif